@@ -1,4 +1,6 @@
 #include "BitmapImage.h"
+#include "ChromaKey.h"
+#include <utility>
 
 
 /**
@@ -6,13 +8,21 @@
 */
 BitmapImage::BitmapImage(void)
 {
-	original = nullptr;
-	bitmap = nullptr;
+	original.reset(new PixelSurface());
+	surface = original;
 	path = L"";
 	name = L"";
 	xPos = 0;
 	yPos = 0;
 	rotation = 0;
+	isKeyed = false;
+	isModified = false;
+	filter = Resampler::FILTER_BILINEAR;
+	isMipmapped = false;
+	isSpanEncoded = false;
+	isHitTested = false;
+	blendMode = PixelSurface::BLEND_ALPHA;
+	SelectBlitter();
 }
 
 
@@ -23,18 +33,74 @@ BitmapImage::BitmapImage(void)
 */
 BitmapImage::BitmapImage(wstring bitmapPath, wstring bitmapName)
 {
-	original = new Gdiplus::Bitmap(bitmapPath.c_str());
-	bitmap = new Gdiplus::Bitmap(bitmapPath.c_str());
+	original = ImageCache::Load(bitmapPath);
+	surface = original;
 	path = bitmapPath;
 	name = bitmapName;
 	xPos = 0;
 	yPos = 0;
 	rotation = 0;
+	isKeyed = false;
+	isModified = false;
+	filter = Resampler::FILTER_BILINEAR;
+	isMipmapped = false;
+	isSpanEncoded = false;
+	isHitTested = false;
+	blendMode = PixelSurface::BLEND_ALPHA;
+	SelectBlitter();
 }
 
 
 /**
-\brief		Destructor for a BitmapImage. Currently does nothing.
+\brief		Constructs a BitmapImage object by taking the surfaces and settings of the passed BitmapImage.
+\details	The passed BitmapImage is left without pixels.
+\param[in]	bitmap The BitmapImage to move from.
+*/
+BitmapImage::BitmapImage(BitmapImage&& bitmap)
+{
+	*this = std::move(bitmap);
+}
+
+
+/**
+\brief		Replaces the surfaces and settings of the BitmapImage with those of the passed BitmapImage.
+\details	The pixels are not copied, the passed BitmapImage is left without pixels.
+\param[in]	bitmap The BitmapImage to move from.
+\return		A reference to this BitmapImage.
+*/
+BitmapImage& BitmapImage::operator=(BitmapImage&& bitmap)
+{
+	if (this != &bitmap)
+	{
+		original = std::move(bitmap.original);
+		surface = std::move(bitmap.surface);
+		mipmaps = std::move(bitmap.mipmaps);
+		rotations = std::move(bitmap.rotations);
+		name = std::move(bitmap.name);
+		path = std::move(bitmap.path);
+		xPos = bitmap.xPos;
+		yPos = bitmap.yPos;
+		rotation = bitmap.rotation;
+		colorKey = bitmap.colorKey;
+		isKeyed = bitmap.isKeyed;
+		isModified = bitmap.isModified;
+		filter = bitmap.filter;
+		isMipmapped = bitmap.isMipmapped;
+		isSpanEncoded = bitmap.isSpanEncoded;
+		isHitTested = bitmap.isHitTested;
+		blendMode = bitmap.blendMode;
+		blitter = bitmap.blitter;
+		spans = std::move(bitmap.spans);
+		bitmap.spans.Clear();
+		mask = std::move(bitmap.mask);
+		bitmap.mask.Clear();
+	}
+	return *this;
+}
+
+
+/**
+\brief		Destructor for a BitmapImage. The surfaces are freed once no BitmapImage shares them.
 */
 BitmapImage::~BitmapImage(void)
 {
@@ -42,37 +108,92 @@ BitmapImage::~BitmapImage(void)
 
 
 /**
-\brief		Draws the BitmapImage to the window using the passed Gdiplus::Graphics pointer.
-\param[in]	g The pointer to the graphics object used to draw to the window.
-\param[in]	ia The pointer to the image attributes object used to specify draw attributes.
+\brief		Draws the BitmapImage onto the passed target surface.
+\details	The image is drawn by the blit kernel picked for its blend mode, rotation and sampling.
+			A rotated image is drawn rotated about its center, from the rotation cache if it has one and
+			is alpha blended, and is sampled bilinearly unless the BitmapImage is resized with the nearest
+			filter. An unrotated, alpha blended image that is span encoded is drawn from its spans, skipping its
+			transparent pixels.
+			If a color key is passed, the image is drawn unrotated with the colors in the key range left out.
+			The rotated frame is prepared first, so Draw must not be called while the image is being drawn
+			by other threads.
+\param[in]	target The surface to draw onto, normally the window's back buffer.
+\param[in]	key The range of colors to draw as transparent, or NULL to draw every pixel.
+*/
+void BitmapImage::Draw(PixelSurface* target, const ColorKey* key)
+{
+	if (key == NULL)
+	{
+		Unpin();
+		Prepare(rotation);
+	}
+	DrawAt(target, xPos, yPos, rotation, key);
+}
+
+
+/**
+\brief		Draws the BitmapImage onto the passed target surface at the passed position and rotation.
+\details	Draws the same pixels as Draw would with the image moved and rotated to match, without changing
+			the image, so one image can be drawn in many places from several threads at once. Nothing is
+			built here: a rotation without a frame prepared by Prepare is rotated straight onto the target.
+\param[in]	target The surface to draw onto.
+\param[in]	x The X coordinate to draw the unrotated bitmap at.
+\param[in]	y The Y coordinate to draw the unrotated bitmap at.
+\param[in]	degrees The rotation to draw the bitmap at.
+\param[in]	key The range of colors to draw as transparent, or NULL to draw every pixel.
 */
-void BitmapImage::Draw(Gdiplus::Graphics* g, Gdiplus::ImageAttributes* ia)
+void BitmapImage::DrawAt(PixelSurface* target, int x, int y, int degrees, const ColorKey* key)
 {
+	// check if color key is required
+	if (key != NULL)
+	{
+		target->BlendKeyed(surface.get(), x, y, key);
+	}
 	// check if image requires rotation
-	if (rotation > 0)
+	else if (rotations != nullptr && blendMode == PixelSurface::BLEND_ALPHA)
+	{
+		rotations->Draw(target, surface.get(), x, y, degrees, GetSampling());
+	}
+	else if (degrees == 0 && blendMode == PixelSurface::BLEND_ALPHA && isSpanEncoded == true)
 	{
-		// find origin point - center of the bitmap
-		Gdiplus::PointF origin((Gdiplus::REAL)xPos + (GetWidth() / 2), (Gdiplus::REAL)yPos + (GetHeight() / 2));
-		// matrix object used to rotate at bitmap origin point
-		Gdiplus::Matrix matrix;
-		// update matrix object as product of itself and matrix that represents rotation about origin point
-		matrix.RotateAt((Gdiplus::REAL)rotation, origin);
-		// update graphics object as product of itself and matrix object
-		g->MultiplyTransform(&matrix);		
+		spans.Draw(target, x, y);
 	}
-	// draw image to window
-	// check if image attributes are required
-	if (ia == NULL)
+	// the kernel picked for the image's own rotation only draws rotations on the same side of 0
+	else if ((degrees == 0) == (rotation == 0))
 	{
-		g->DrawImage(bitmap, xPos, yPos);
+		blitter(target, surface.get(), x, y, degrees, NULL);
 	}
 	else
 	{
-		g->DrawImage(bitmap, RectF(0, 0, (Gdiplus::REAL)GetWidth(), (Gdiplus::REAL)GetHeight()), 0, 0,
-			(Gdiplus::REAL)GetWidth(), (Gdiplus::REAL)GetHeight(), UnitPixel, ia);
-	}	
-	// reset the graphics transformation
-	g->ResetTransform();	
+		PixelSurface::SelectBlitter(blendMode, degrees != 0, GetSampling())(target, surface.get(), x, y, degrees, NULL);
+	}
+}
+
+
+/**
+\brief		Builds the rotated frame a Draw at the passed rotation would render on first use.
+\details	The frame stays in the rotation cache until Unpin is called, so every rotation prepared for
+			a frame of the game is drawn from the cache, unless the cache is too full to hold it.
+\param[in]	degrees The rotation the image will be drawn at.
+*/
+void BitmapImage::Prepare(int degrees)
+{
+	if (rotations != nullptr && blendMode == PixelSurface::BLEND_ALPHA)
+	{
+		rotations->Prepare(surface.get(), degrees, GetSampling());
+	}
+}
+
+
+/**
+\brief		Lets the rotation cache free the frames prepared so far, once they have been drawn.
+*/
+void BitmapImage::Unpin(void)
+{
+	if (rotations != nullptr)
+	{
+		rotations->Unpin();
+	}
 }
 
 
@@ -87,26 +208,57 @@ void BitmapImage::Draw(Gdiplus::Graphics* g, Gdiplus::ImageAttributes* ia)
 \param[in]	scaleDimensions Indicates if the width and height parameters are exact or scalar values.
 */
 void BitmapImage::Resize(double width, double height, bool scaleDimensions)
+{
+	int newWidth;
+	int newHeight;
+	ScaledSize(width, height, scaleDimensions, &newWidth, &newHeight);
+	// scale the original surface onto the drawn surface
+	ScaleSurface(newWidth, newHeight);
+}
+
+
+/**
+\brief		Describes the surface a later call to Resize with the same parameters will need.
+\details	Nothing about the BitmapImage changes. The requests can be passed to the ImageCache from 
+			another thread, so the surface is already scaled when Resize is called. A BitmapImage whose
+			original has been modified adds no request, because its surfaces are not shared.
+\param[in]	width Either the new width or the scaled width depending on scaleDimensions.
+\param[in]	height Either the new height or the scaled height depending on scaleDimensions.
+\param[in]	scaleDimensions Indicates if the width and height parameters are exact or scalar values.
+\param[out]	requests The list the request for the scaled surface is added to.
+*/
+void BitmapImage::RequestResize(double width, double height, bool scaleDimensions, std::vector<ImageRequest>* requests)
+{
+	if (isModified == true)
+	{
+		return;
+	}
+	int newWidth;
+	int newHeight;
+	ScaledSize(width, height, scaleDimensions, &newWidth, &newHeight);
+	requests->push_back(Describe(newWidth, newHeight));
+}
+
+
+/**
+\brief		Calculates the size of the resized bitmap from the parameters of Resize.
+\param[in]	width Either the new width or the scaled width depending on scaleDimensions.
+\param[in]	height Either the new height or the scaled height depending on scaleDimensions.
+\param[in]	scaleDimensions Indicates if the width and height parameters are exact or scalar values.
+\param[out]	newWidth The width of the resized bitmap.
+\param[out]	newHeight The height of the resized bitmap.
+*/
+void BitmapImage::ScaledSize(double width, double height, bool scaleDimensions, int* newWidth, int* newHeight)
 {
 	// default new dimentions as fixed pixel measurements
-	int newWidth = (int)width;
-	int newHeight = (int)height;
+	*newWidth = (int)width;
+	*newHeight = (int)height;
 	// set new dimentions as scalars of the original image measurements
 	if (scaleDimensions == true)
 	{
-		newWidth = (int)(original->GetWidth() * width);
-		newHeight = (int)(original->GetHeight() * height);
+		*newWidth = (int)(original->GetWidth() * width);
+		*newHeight = (int)(original->GetHeight() * height);
 	}
-	// set the bounds for the resized image
-	Gdiplus::Rect dest(0, 0, newWidth, newHeight);
-	// set the temporary drawn bitmap to a new bitmap with the new width and height
-	// also specify that the new bitmap supports an alpha channel (32-bit)
-	delete bitmap;
-	bitmap = new Gdiplus::Bitmap(newWidth, newHeight, PixelFormat32bppARGB);
-	// create a graphics object that will draw onto the temporary bitmap
-	Gdiplus::Graphics graphics(bitmap);
-	// use the graphics object to draw the original bitmap onto the scaled temporary bitmap
-	graphics.DrawImage(original, dest);
 }
 
 
@@ -129,6 +281,7 @@ void BitmapImage::Rotate(int degrees)
 		// make degrees a positive value from 0 - 360 
 		rotation = degrees % 360;
 	}
+	SelectBlitter();
 }
 
 
@@ -146,44 +299,262 @@ void BitmapImage::MoveTo(int x, int y)
 \brief		Removes the color indicated by the color parameter from the BitmapImage.
 \param[in]	color The color of the pixels to be set as fully transparent.
 */
-void BitmapImage::RemoveChromaKey(Gdiplus::Color color)
-{
-	Gdiplus::Color pixelColor;
-	Gdiplus::Color transparent(0, 255, 255, 255);
-	int width = bitmap->GetWidth();
-	int height = bitmap->GetHeight();
-	int colorR = color.GetR();
-	int colorG = color.GetG();
-	int colorB = color.GetB();
-	// check each pixel in the bitmap and if its color matches the passed parameter's color,
-	// set the pixel alpha channel to 0 (fully transparent)
-	for (int x = 0; x < width; x++)
+void BitmapImage::RemoveChromaKey(unsigned int color)
+{
+	ColorKey key = { color, color };
+	RemoveChromaKey(&key);
+}
+
+
+/**
+\brief		Removes the range of colors indicated by the key parameter from the BitmapImage.
+\details	Each pixel of the drawn surface whose red, green and blue channels are all within
+			the key range is set fully transparent. The drawn surface may be shared, so the key
+			is applied to a copy that only this BitmapImage uses.
+\param[in]	key The range of colors of the pixels to be set as fully transparent.
+*/
+void BitmapImage::RemoveChromaKey(const ColorKey* key)
+{
+	PixelSurface* keyed = new PixelSurface();
+	keyed->CopyFrom(surface.get());
+	ChromaKey::Apply(keyed, key);
+	surface.reset(keyed);
+	SurfaceChanged();
+}
+
+
+/**
+\brief		Bakes a range of colors into the alpha channel of the BitmapImage after every resize.
+\details	Once a color key is set, the pixels in its range are made fully transparent straight away
+			and again each time the image is resized or reloaded. The image can then be drawn without 
+			a color key, as a plain alpha blend, instead of testing every pixel against the range on 
+			every frame. Passing NULL stops baking the key into later resizes.
+\param[in]	key The range of colors to make fully transparent, or NULL to stop keying.
+*/
+void BitmapImage::SetColorKey(const ColorKey* key)
+{
+	isKeyed = (key != NULL);
+	if (isKeyed == true)
+	{
+		colorKey = *key;
+		ScaleSurface(surface->GetWidth(), surface->GetHeight());
+	}
+}
+
+
+/**
+\brief		Sets the filter used to resize the BitmapImage.
+\details	A cheap filter suits large images like full screen backgrounds, while small sprites can 
+			afford a high quality filter. The drawn surface is rescaled with the new filter.
+\param[in]	resizeFilter The filter to resize with.
+*/
+void BitmapImage::SetFilter(Resampler::Filter resizeFilter)
+{
+	filter = resizeFilter;
+	ScaleSurface(surface->GetWidth(), surface->GetHeight());
+	SelectBlitter();
+}
+
+
+/**
+\brief		Sets if the BitmapImage is resized from a chain of mipmaps.
+\details	The mipmaps are built once for each image file and shared through the ImageCache. Each 
+			resize then scales from the smallest mipmap that is at least as large as the new size 
+			rather than from the full size original, so shrinking a large image is much cheaper and 
+			aliases less. Scales that land exactly on a mipmap, like half or a quarter size, need no
+			scaling at all. A BitmapImage whose original has been modified is not mipmapped.
+\param[in]	mipmapped Indicates if the BitmapImage should be resized from mipmaps.
+*/
+void BitmapImage::SetMipmapped(bool mipmapped)
+{
+	isMipmapped = mipmapped;
+	mipmaps.reset();
+	if (isMipmapped == true && isModified == false)
+	{
+		mipmaps = ImageCache::Mipmaps(path);
+	}
+	ScaleSurface(surface->GetWidth(), surface->GetHeight());
+}
+
+
+/**
+\brief		Sets if the BitmapImage is drawn rotated from a cache of pre-rotated frames.
+\details	Rotations are rounded to the nearest RotationCache::STEP_DEGREES, and each angle is rotated
+			once, the first time it is drawn, and then drawn as a plain blend. The cache is emptied
+			whenever the surface changes, so the frames are rendered again at the new size after a resize. 
+			This suits small sprites that spin every frame.
+\param[in]	cached Indicates if rotations should be drawn from the cache.
+*/
+void BitmapImage::SetRotationCached(bool cached)
+{
+	rotations.reset(cached == true ? new RotationCache() : NULL);
+}
+
+
+/**
+\brief		Sets if unrotated, alpha blended draws of the BitmapImage use spans of its solid pixels.
+\details	The spans are encoded again on the calling thread every time the surface changes, which
+			reads every pixel, so this suits small sprites with large transparent areas. Images drawn
+			some other way, like the background drawn from the flattened cache of its CompositeImage,
+			are better off without them. Drawing without spans blends the same pixels.
+\param[in]	encoded Indicates if the drawn surface should be encoded into spans.
+*/
+void BitmapImage::SetSpanEncoded(bool encoded)
+{
+	isSpanEncoded = encoded;
+	if (isSpanEncoded == true)
+	{
+		spans.Build(surface.get());
+	}
+	else
+	{
+		spans.Clear();
+	}
+}
+
+
+/**
+\brief		Sets if a hit mask of the solid pixels of the BitmapImage is kept for testing shots.
+\details	The mask is built again every time the surface changes, so only images that are shot at,
+			like the reptile frames, should keep one. Without it, GetHitMask returns an empty mask.
+\param[in]	tested Indicates if the hit mask should be built.
+*/
+void BitmapImage::SetHitTested(bool tested)
+{
+	isHitTested = tested;
+	if (isHitTested == true)
+	{
+		mask.Build(surface.get());
+	}
+	else
+	{
+		mask.Clear();
+	}
+}
+
+
+/**
+\brief		Sets how the BitmapImage is combined with the pixels underneath it.
+\details	Opaque images can be copied, skipping the blend, and effects like flashes can be added.
+			The rotation cache is only used with BLEND_ALPHA, other modes rotate while drawing.
+\param[in]	mode The blend mode to draw with.
+*/
+void BitmapImage::SetBlendMode(PixelSurface::BlendMode mode)
+{
+	blendMode = mode;
+	SelectBlitter();
+}
+
+
+/**
+\brief		Picks the blit kernel for the current blend mode, rotation and sampling.
+\details	Called whenever one of them changes, so drawing needs no decisions per pixel.
+*/
+void BitmapImage::SelectBlitter(void)
+{
+	blitter = PixelSurface::SelectBlitter(blendMode, rotation != 0, GetSampling());
+}
+
+
+/**
+\brief		Rebuilds everything derived from the drawn surface after it has been replaced.
+\details	The surface is encoded into spans again if the BitmapImage is span encoded, so unrotated
+			draws skip its transparent pixels, its hit mask is rebuilt to match its new size if it is
+			hit tested, and the rotation cache, if there is one, is emptied.
+*/
+void BitmapImage::SurfaceChanged(void)
+{
+	if (isSpanEncoded == true)
+	{
+		spans.Build(surface.get());
+	}
+	if (isHitTested == true)
+	{
+		mask.Build(surface.get());
+	}
+	if (rotations != nullptr)
+	{
+		rotations->Clear();
+	}
+}
+
+
+/**
+\brief		Replaces the drawn surface with the original scaled to the passed size.
+\details	The color key is baked into the scaled surface if the BitmapImage is keyed. Unless the 
+			original has been modified, the scaled surface comes from the ImageCache, so it is only 
+			scaled and keyed once for all the BitmapImages showing the same file at the same size.
+\param[in]	newWidth The width of the drawn surface.
+\param[in]	newHeight The height of the drawn surface.
+*/
+void BitmapImage::ScaleSurface(int newWidth, int newHeight)
+{
+	if (isModified == false)
+	{
+		ImageRequest request = Describe(newWidth, newHeight);
+		surface = ImageCache::Get(&request);
+		SurfaceChanged();
+		return;
+	}
+	const ColorKey* key = isKeyed == true ? &colorKey : NULL;
+	PixelSurface* scaled = new PixelSurface();
+	Resampler::Scale(scaled, original.get(), newWidth, newHeight, filter);
+	if (key != NULL)
 	{
-		for (int y = 0; y < height; y++)
-		{
-			bitmap->GetPixel(x, y, &pixelColor);
-			// compare the pixel's rgb values to the parameter color's rgb values
-			if (pixelColor.GetR() == colorR && pixelColor.GetG() == colorG && pixelColor.GetB() == colorB)
-			{
-				bitmap->SetPixel(x, y, transparent);
-			}
-		}
+		ChromaKey::Apply(scaled, key);
 	}
+	surface.reset(scaled);
+	SurfaceChanged();
+}
+
+
+/**
+\brief		Describes the version of the image file drawn at the passed size.
+\param[in]	newWidth The width of the drawn surface.
+\param[in]	newHeight The height of the drawn surface.
+\return		The request to pass to the ImageCache.
+*/
+ImageRequest BitmapImage::Describe(int newWidth, int newHeight)
+{
+	ImageRequest request = { path, newWidth, newHeight, isKeyed, colorKey, filter, isMipmapped };
+	return request;
+}
+
+
+/**
+\brief		Picks how rotated draws sample the surface to match the resize filter.
+\return		Nearest sampling for the nearest filter, otherwise bilinear sampling.
+*/
+PixelSurface::Sampling BitmapImage::GetSampling(void)
+{
+	return filter == Resampler::FILTER_NEAREST ? PixelSurface::SAMPLING_NEAREST : PixelSurface::SAMPLING_BILINEAR;
+}
+
+
+/**
+\brief		Draws the BitmapImage from a surface made elsewhere, such as its rectangle of a SpriteAtlas.
+\details	The surface should hold the same pixels as the current one. It is replaced again by the 
+			next resize.
+\param[in]	drawnSurface The surface to draw.
+*/
+void BitmapImage::SetSurface(std::shared_ptr<const PixelSurface> drawnSurface)
+{
+	surface = drawnSurface;
+	SurfaceChanged();
 }
 
 
 /**
 \brief		Saves the temporary bitmap drawn to the window as the original bitmap.
-\details	Copies and sets the temporary bitmap drawn to the current window size as 
-			the original bitmap that is used to maintain image quality.
+\details	Sets the temporary bitmap drawn to the current window size as the original
+			bitmap that is used to maintain image quality. Later resizes are scaled from it 
+			rather than from the image file.
 */
 void BitmapImage::SaveBitmapAsOriginal(void)
 {
-	Gdiplus::Rect dest(0, 0, bitmap->GetWidth(), bitmap->GetHeight());
-	delete original;
-	original = new Gdiplus::Bitmap(bitmap->GetWidth(), bitmap->GetHeight(), PixelFormat32bppARGB);
-	Gdiplus::Graphics graphics(original);
-	graphics.DrawImage(bitmap, dest);
+	original = surface;
+	mipmaps.reset();
+	isModified = true;
 }
 
 
@@ -194,10 +565,18 @@ void BitmapImage::SaveBitmapAsOriginal(void)
 void BitmapImage::SetPath(wstring bitmapPath)
 {
 	path = bitmapPath;
-	delete original;
-	delete bitmap;
-	original = new Gdiplus::Bitmap(bitmapPath.c_str());
-	bitmap = new Gdiplus::Bitmap(bitmapPath.c_str());
+	original = ImageCache::Load(bitmapPath);
+	surface = original;
+	isModified = false;
+	SurfaceChanged();
+	if (isMipmapped == true)
+	{
+		mipmaps = ImageCache::Mipmaps(bitmapPath);
+	}
+	if (isKeyed == true)
+	{
+		ScaleSurface(surface->GetWidth(), surface->GetHeight());
+	}
 }
 
 
@@ -257,7 +636,7 @@ int BitmapImage::GetYPos(void)
 */
 int BitmapImage::GetWidth(void)
 {
-	return bitmap->GetWidth();
+	return surface->GetWidth();
 }
 
 
@@ -267,7 +646,7 @@ int BitmapImage::GetWidth(void)
 */
 int BitmapImage::GetHeight(void)
 {
-	return bitmap->GetHeight();
+	return surface->GetHeight();
 }
 
 
@@ -282,10 +661,125 @@ int BitmapImage::GetRotation(void)
 
 
 /**
-\brief		Returns a pointer to the Gdiplus::Bitmap object.
-\return		A pointer to the Gdiplus::Bitmap object.
+\brief		Returns the filter used to resize the BitmapImage.
+\return		The resize filter.
+*/
+Resampler::Filter BitmapImage::GetFilter(void)
+{
+	return filter;
+}
+
+
+/**
+\brief		Returns if the BitmapImage is resized from mipmaps.
+\return		True if the BitmapImage is mipmapped.
+*/
+bool BitmapImage::IsMipmapped(void)
+{
+	return isMipmapped;
+}
+
+
+/**
+\brief		Returns if the BitmapImage is drawn rotated from a cache.
+\return		True if rotations are cached.
+*/
+bool BitmapImage::IsRotationCached(void)
+{
+	return rotations != nullptr;
+}
+
+
+/**
+\brief		Returns if unrotated draws of the BitmapImage use spans of its solid pixels.
+\return		True if the drawn surface is encoded into spans.
+*/
+bool BitmapImage::IsSpanEncoded(void)
+{
+	return isSpanEncoded;
+}
+
+
+/**
+\brief		Returns if a hit mask is kept for the BitmapImage.
+\return		True if the hit mask is built whenever the surface changes.
+*/
+bool BitmapImage::IsHitTested(void)
+{
+	return isHitTested;
+}
+
+
+/**
+\brief		Returns how the BitmapImage is combined with the pixels underneath it.
+\return		The blend mode.
+*/
+PixelSurface::BlendMode BitmapImage::GetBlendMode(void)
+{
+	return blendMode;
+}
+
+
+/**
+\brief		Returns the spans the BitmapImage is drawn from, along with their fill rate statistics.
+\return		A pointer to the spans of the drawn surface, empty unless the BitmapImage is span encoded.
+*/
+SpanSprite* BitmapImage::GetSpans(void)
+{
+	return &spans;
+}
+
+
+/**
+\brief		Returns the solid pixels of the drawn surface, for testing hits against the unrotated bitmap.
+\details	The mask is rebuilt in place whenever the surface changes, so the pointer stays valid for
+			as long as the BitmapImage is not moved. It is empty unless the BitmapImage is hit tested.
+\return		A pointer to the hit mask of the drawn surface.
+*/
+const HitMask* BitmapImage::GetHitMask(void)
+{
+	return &mask;
+}
+
+
+/**
+\brief		Returns the area of the target the BitmapImage covers when it is drawn without a color key.
+\details	This is the bounding box of the rotated image, rounded to a cached angle if rotations are cached.
+\return		The bounds of the drawn image.
+*/
+PixelRect BitmapImage::GetBounds(void)
+{
+	return GetBoundsAt(xPos, yPos, rotation);
+}
+
+
+/**
+\brief		Returns the area of the target the BitmapImage covers when it is drawn by DrawAt without a color key.
+\param[in]	x The X coordinate the unrotated bitmap is drawn at.
+\param[in]	y The Y coordinate the unrotated bitmap is drawn at.
+\param[in]	degrees The rotation the bitmap is drawn at.
+\return		The bounds of the drawn image.
+*/
+PixelRect BitmapImage::GetBoundsAt(int x, int y, int degrees)
+{
+	if (rotations != nullptr)
+	{
+		return RotationCache::Bounds(x, y, surface->GetWidth(), surface->GetHeight(), degrees);
+	}
+	if (degrees != 0)
+	{
+		return PixelSurface::RotatedBounds(x, y, surface->GetWidth(), surface->GetHeight(), degrees);
+	}
+	PixelRect bounds = { x, y, surface->GetWidth(), surface->GetHeight() };
+	return bounds;
+}
+
+
+/**
+\brief		Returns a pointer to the PixelSurface drawn to the window.
+\return		A pointer to the PixelSurface object.
 */
-Gdiplus::Bitmap* BitmapImage::GetBitmap(void)
+const PixelSurface* BitmapImage::GetSurface(void)
 {
-	return bitmap;
+	return surface.get();
 }
\ No newline at end of file
@@ -1,7 +1,11 @@
-#include <windows.h>
-#include <gdiplus.h>
+#include "PixelSurface.h"
+#include "ImageCache.h"
+#include "RotationCache.h"
+#include "SpanSprite.h"
+#include "HitMask.h"
 #include <string>
-using namespace Gdiplus;
+#include <vector>
+#include <memory>
 using namespace std;
 
 
@@ -17,30 +21,71 @@ using namespace std;
 \details	A BitmapImage instance is essentially an image object that can be scaled, positioned 
 			and modified without changing the original image file located on the disk or sacrificing 
 			the original image quality. A BitmapImage is also constructed with a name to distinguish
-			it from other BitmapImages that may be stored in a data stucture or CompositeImage.
+			it from other BitmapImages that may be stored in a data stucture or CompositeImage. The pixels
+			are kept in PixelSurface objects and drawn in software onto a PixelSurface, so only loading
+			the image file depends on the platform. The surfaces are shared through the ImageCache with 
+			every other BitmapImage showing the same file at the same size, so a BitmapImage only owns 
+			its position and rotation. It can be moved into a container but not copied.
 */
 class BitmapImage
 {
 
 private:
-	Gdiplus::Bitmap* original;	// used to maintain original image quality
-	Gdiplus::Bitmap* bitmap;	// the resized/modified bitmap drawn to the window
+	std::shared_ptr<const PixelSurface> original;	// used to maintain original image quality
+	std::shared_ptr<const PixelSurface> surface;	// the resized/modified surface drawn to the window
+	std::shared_ptr<const MipChain> mipmaps;		// the halved copies of the original, if mipmapped
+	std::unique_ptr<RotationCache> rotations;		// the surface pre-rotated to each angle, if cached
+	SpanSprite spans;							// the runs of the drawn surface that are not transparent, if encoded
+	HitMask mask;								// the solid pixels of the drawn surface, if hit tested
 	wstring name;				// the name of the bitmap image
 	wstring path;				// the path to the bitmap's file location
 	int xPos;					// the X coordinate to draw the bitmap
 	int yPos;					// the Y coordinate to draw the bitmap
 	int rotation;				// the rotation of the bitmap to draw
+	ColorKey colorKey;			// the range of colors baked into the alpha channel
+	bool isKeyed;				// indicates if the color key is baked in after every resize
+	bool isModified;			// indicates if the original no longer matches the image file
+	Resampler::Filter filter;	// the filter used to resize the bitmap
+	bool isMipmapped;			// indicates if the bitmap is resized from the nearest larger mipmap
+	bool isSpanEncoded;			// indicates if unrotated draws use the spans of the drawn surface
+	bool isHitTested;			// indicates if a hit mask is kept for the drawn surface
+	PixelSurface::BlendMode blendMode;	// how the bitmap is combined with the pixels underneath
+	PixelSurface::Blitter blitter;		// the kernel that draws the bitmap without a color key
+
+	void ScaleSurface(int newWidth, int newHeight);
+	ImageRequest Describe(int newWidth, int newHeight);
+	void SurfaceChanged(void);
+	PixelSurface::Sampling GetSampling(void);
+	void SelectBlitter(void);
+	void ScaledSize(double width, double height, bool scaleDimensions, int* newWidth, int* newHeight);
 
 public:
 	BitmapImage(void);
 	BitmapImage(wstring bitmapPath, wstring bitmapName);
+	BitmapImage(BitmapImage&& bitmap);
+	BitmapImage& operator=(BitmapImage&& bitmap);
+	BitmapImage(const BitmapImage& bitmap) = delete;
+	BitmapImage& operator=(const BitmapImage& bitmap) = delete;
 	~BitmapImage(void);
 
-	void Draw(Gdiplus::Graphics* g, Gdiplus::ImageAttributes* ia = NULL);
+	void Draw(PixelSurface* target, const ColorKey* key = NULL);
+	void DrawAt(PixelSurface* target, int x, int y, int degrees, const ColorKey* key = NULL);
+	void Prepare(int degrees);
+	void Unpin(void);
 	void Resize(double width, double height, bool scaleDimensions = false);
+	void RequestResize(double width, double height, bool scaleDimensions, std::vector<ImageRequest>* requests);
 	void Rotate(int degrees);
 	void MoveTo(int x, int y);
-	void RemoveChromaKey(Gdiplus::Color color);
+	void RemoveChromaKey(unsigned int color);
+	void RemoveChromaKey(const ColorKey* key);
+	void SetColorKey(const ColorKey* key);
+	void SetFilter(Resampler::Filter resizeFilter);
+	void SetMipmapped(bool mipmapped);
+	void SetRotationCached(bool cached);
+	void SetSpanEncoded(bool encoded);
+	void SetHitTested(bool tested);
+	void SetBlendMode(PixelSurface::BlendMode mode);
+	void SetSurface(std::shared_ptr<const PixelSurface> drawnSurface);
 	void SaveBitmapAsOriginal(void);
 	
 	void SetPath(wstring bitmapPath);
@@ -52,7 +97,17 @@ public:
 	int GetWidth(void);
 	int GetHeight(void);
 	int GetRotation(void);
-	Gdiplus::Bitmap* GetBitmap(void);
+	Resampler::Filter GetFilter(void);
+	bool IsMipmapped(void);
+	bool IsRotationCached(void);
+	bool IsSpanEncoded(void);
+	bool IsHitTested(void);
+	PixelSurface::BlendMode GetBlendMode(void);
+	SpanSprite* GetSpans(void);
+	const HitMask* GetHitMask(void);
+	PixelRect GetBounds(void);
+	PixelRect GetBoundsAt(int x, int y, int degrees);
+	const PixelSurface* GetSurface(void);
 
 };
 
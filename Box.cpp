@@ -1,5 +1,4 @@
 #include "Box.h"
-#include "Scoreboard.h"
 
 
 // class constants
@@ -8,14 +7,20 @@ const float Box::FRICTION = 0.07f;
 
 /**
 \brief		Constructs a Box object and sets default values for members.
+\param[in]	xStart The X coordinate of the default box position.
+\param[in]	yStart The Y coordinate of the default box position.
+\param[in]	boxWidth The width of the box.
+\param[in]	boxHeight The height of the box.
 */
-Box::Box(wstring bitmapPath, wstring bitmapName, int xStart, int yStart) : BitmapImage(bitmapPath, bitmapName)
+Box::Box(int xStart, int yStart, int boxWidth, int boxHeight)
 {
 	MoveTo(xStart, yStart); 
+	width = boxWidth;
+	height = boxHeight;
 	xStartPos = xStart;
 	yStartPos = yStart;
 	xPrevPos = xStartPos;
-	xPrevPos = xStartPos;
+	yPrevPos = yStartPos;
 	xVel = 0;	
 	yVel = 0;		
 }
@@ -185,7 +190,7 @@ void Box::Reset(void)
 {
 	MoveTo(xStartPos, yStartPos);
 	xPrevPos = xStartPos;
-	xPrevPos = xStartPos;
+	yPrevPos = yStartPos;
 	xVel = 0;
 	yVel = 0;
 }
@@ -211,3 +216,105 @@ void Box::SetYVel(float yVel)
 }
 
 
+/**
+\brief		Translates the box object to the passed X and Y coordinates.
+\param[in]	x The new X coordinate of the box.
+\param[in]	y The new Y coordinate of the box.
+*/
+void Box::MoveTo(int x, int y)
+{
+	xPos = x;
+	yPos = y;
+}
+
+
+/**
+\brief		Sets the width and height of the box object used for collision checks.
+\param[in]	width The new width of the box.
+\param[in]	height The new height of the box.
+*/
+void Box::SetSize(int width, int height)
+{
+	Box::width = width;
+	Box::height = height;
+}
+
+
+/**
+\brief		Returns the X coordinate of the box object.
+\return		The X coordinate of the box.
+*/
+int Box::GetXPos(void)
+{
+	return xPos;
+}
+
+
+/**
+\brief		Returns the Y coordinate of the box object.
+\return		The Y coordinate of the box.
+*/
+int Box::GetYPos(void)
+{
+	return yPos;
+}
+
+
+/**
+\brief		Returns the width of the box object.
+\return		The width of the box.
+*/
+int Box::GetWidth(void)
+{
+	return width;
+}
+
+
+/**
+\brief		Returns the height of the box object.
+\return		The height of the box.
+*/
+int Box::GetHeight(void)
+{
+	return height;
+}
+
+
+/**
+\brief		Returns the X coordinate the box was at before its last update.
+\return		The previous X coordinate of the box.
+*/
+int Box::GetXPrevPos(void)
+{
+	return xPrevPos;
+}
+
+
+/**
+\brief		Returns the Y coordinate the box was at before its last update.
+\return		The previous Y coordinate of the box.
+*/
+int Box::GetYPrevPos(void)
+{
+	return yPrevPos;
+}
+
+
+/**
+\brief		Returns the horizontal velocity of the box object.
+\return		The horizontal velocity of the box.
+*/
+float Box::GetXVel(void)
+{
+	return xVel;
+}
+
+
+/**
+\brief		Returns the vertical velocity of the box object.
+\return		The vertical velocity of the box.
+*/
+float Box::GetYVel(void)
+{
+	return yVel;
+}
\ No newline at end of file
@@ -1,10 +1,4 @@
-#include "BitmapImage.h"
 #include "Reptile.h"
-#include <windows.h>
-#include <gdiplus.h>
-#include <string>
-using namespace Gdiplus;
-using namespace std;
 
 
 #ifndef __BOX_H__
@@ -18,12 +12,17 @@ using namespace std;
 \brief		Represents and keeps track of a box object.
 \details	Contains methods for checking for boundary collisions with other objects, 
 			updating the position of the box on screen, resetting the box to a starting position
-			and updating the X and Y velocity of the box. Inherits from the BitmapImage class.
+			and updating the X and Y velocity of the box. The Box only tracks its position and size; 
+			the bitmap representing it is drawn separately so the box can be simulated without a window.
 */
-class Box : public BitmapImage
+class Box
 {
 
 private:
+	int xPos;							// X coordinate of the box
+	int yPos;							// Y coordinate of the box
+	int width;							// the width of the box
+	int height;							// the height of the box
 	int xStartPos;						// X coordinate of default box position
 	int yStartPos;						// Y coordinate of default box position
 	int xPrevPos;						// X coordinate of previous box position
@@ -34,7 +33,7 @@ private:
 public:
 	static const float FRICTION;		// force of friction on the box
 
-	Box(wstring bitmapPath, wstring bitmapName, int xStart, int yStart);
+	Box(int xStart, int yStart, int boxWidth, int boxHeight);
 	~Box(void);
 
 	bool CheckCollision(int windowWidth, int windowHeight, Box* b, bool sideways = false);
@@ -44,6 +43,17 @@ public:
 	void SetXVel(float xVel);
 	void SetYVel(float yVel);
 
+	void MoveTo(int x, int y);
+	void SetSize(int width, int height);
+	int GetXPos(void);
+	int GetYPos(void);
+	int GetWidth(void);
+	int GetHeight(void);
+	int GetXPrevPos(void);
+	int GetYPrevPos(void);
+	float GetXVel(void);
+	float GetYVel(void);
+
 };
 
 
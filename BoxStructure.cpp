@@ -0,0 +1,152 @@
+#include "BoxStructure.h"
+#include <cstdlib>
+
+
+// class constants
+const char* BoxStructure::PYRAMID =
+	"# one box on top, two boxes in the middle and three boxes on the ground\n"
+	"at 0.3\n"
+	"  []\n"
+	" [][]\n"
+	"[][][]\n";
+
+
+/**
+\brief		Constructs a BoxStructure object without any boxes.
+*/
+BoxStructure::BoxStructure(void)
+{
+}
+
+
+/**
+\brief		Destructor for a BoxStructure. Currently does nothing.
+*/
+BoxStructure::~BoxStructure(void)
+{
+}
+
+
+/**
+\brief		Reads the boxes of every structure in the passed description.
+\details	Lines may end with "\r\n" or "\n", and blank lines are ignored. A row of only '.' is not
+			blank, it is a row without any boxes that keeps the rows above it up in the air. A description
+			that is not understood leaves the boxes of the last description read unchanged.
+\param[in]	description The text describing the structures.
+\return		True if the description was read, false if a line is not understood.
+*/
+bool BoxStructure::Parse(const string& description)
+{
+	std::vector<Cell> parsed;
+	std::vector<string> rows;			// the rows of the structure being read, from the top down
+	double left = -1;					// the left edge of the structure being read, -1 before the first
+	size_t start = 0;
+	while (start < description.size())
+	{
+		// the next line, without its line break
+		size_t end = description.find('\n', start);
+		if (end == string::npos)
+		{
+			end = description.size();
+		}
+		string line = description.substr(start, end - start);
+		if (line.empty() == false && line[line.size() - 1] == '\r')
+		{
+			line.erase(line.size() - 1);
+		}
+		start = end + 1;
+
+		if (line.find_first_not_of(' ') == string::npos || line[0] == '#')
+		{
+			continue;
+		}
+		// a new structure finishes the rows of the last one
+		if (line.compare(0, 3, "at ") == 0)
+		{
+			AddRows(left, &rows, &parsed);
+			char* number = NULL;
+			left = strtod(line.c_str() + 3, &number);
+			if (number == line.c_str() + 3 || left < 0 || left > 1)
+			{
+				return false;
+			}
+			continue;
+		}
+
+		// a row of the structure, where every box must be closed
+		if (left < 0)
+		{
+			return false;
+		}
+		for (unsigned int c = 0; c < line.size(); c++)
+		{
+			if (line[c] == '[' && c + 1 < line.size() && line[c + 1] == ']')
+			{
+				c++;
+			}
+			else if (line[c] != ' ' && line[c] != '.')
+			{
+				return false;
+			}
+		}
+		rows.push_back(line);
+	}
+	AddRows(left, &rows, &parsed);
+
+	cells = parsed;
+	return true;
+}
+
+
+/**
+\brief		Replaces the passed boxes with the boxes of the structures, placed edge to edge on the ground.
+\param[in]	worldWidth The width of the world the structures stand in.
+\param[in]	groundY The Y coordinate of the ground, which the bottom row of each structure stands on.
+\param[in]	boxWidth The width of every box.
+\param[in]	boxHeight The height of every box.
+\param[out]	boxes The boxes of the world, replaced by the boxes of the structures in the order they were described.
+*/
+void BoxStructure::Build(int worldWidth, int groundY, int boxWidth, int boxHeight, std::vector<Box>* boxes)
+{
+	boxes->clear();
+	for (unsigned int i = 0; i < cells.size(); i++)
+	{
+		int x = (int)(worldWidth * cells[i].left) + cells[i].column * boxWidth / 2;
+		int y = groundY - (cells[i].row + 1) * boxHeight;
+		boxes->push_back(Box(x, y, boxWidth, boxHeight));
+	}
+}
+
+
+/**
+\brief		Returns the number of boxes in all the structures.
+\return		The number of boxes described.
+*/
+int BoxStructure::BoxCount(void)
+{
+	return cells.size();
+}
+
+
+/**
+\brief		Adds the boxes of the rows of a structure, counting the rows up from the last one on the ground.
+\param[in]	left The fraction of the world's width the structure's left edge is at.
+\param[in,out]	rows The rows of the structure from the top down, emptied once their boxes are added.
+\param[out]	parsed The boxes read so far, which the boxes of the rows are added to.
+*/
+void BoxStructure::AddRows(double left, std::vector<string>* rows, std::vector<Cell>* parsed)
+{
+	for (unsigned int r = 0; r < rows->size(); r++)
+	{
+		const string* row = &(*rows)[r];
+		for (unsigned int c = 0; c < row->size(); c++)
+		{
+			if ((*row)[c] == '[')
+			{
+				Cell cell = { left, (int)c, (int)(rows->size() - 1 - r) };
+				parsed->push_back(cell);
+			}
+		}
+	}
+	rows->clear();
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include "Box.h"
+#include <string>
+#include <vector>
+using namespace std;
+
+
+#ifndef __BOX_STRUCTURE_H__
+#define __BOX_STRUCTURE_H__
+
+
+/**
+\class		BoxStructure
+\author		Tom Bisch
+\date		Jun 6, 2016
+\brief		Describes structures of boxes standing on the ground, drawn as text, and builds their boxes.
+\details	A description holds any number of structures. Each structure starts with a line "at X", where
+			X is the fraction of the world's width its left edge stands at, followed by its rows from the
+			top down, the last row standing on the ground. In a row every character is half a box wide,
+			"[]" is a box and a space or '.' is empty, so each row can be offset from the one below by
+			half a box, like bricks. Blank lines are skipped, so an empty row is written with '.'. Lines
+			starting with '#' are comments. For example, a pyramid of six boxes a third of the way across
+			the world is:
+
+				at 0.3
+				  []
+				 [][]
+				[][][]
+
+			The boxes are placed edge to edge in the size they are built with, so they rest on each other.
+*/
+class BoxStructure
+{
+
+private:
+	// a box of the description
+	struct Cell
+	{
+		double left;					// the fraction of the world's width the structure's left edge is at
+		int column;						// the column of the box's left edge, in half boxes from the structure's left edge
+		int row;						// the row of the box, counting up from 0 on the ground
+	};
+
+	std::vector<Cell> cells;			// the boxes of every structure
+
+	static void AddRows(double left, std::vector<string>* rows, std::vector<Cell>* parsed);
+
+public:
+	static const char* PYRAMID;			// the description of the six box pyramid the game starts with
+
+	BoxStructure(void);
+	~BoxStructure(void);
+
+	bool Parse(const string& description);
+	void Build(int worldWidth, int groundY, int boxWidth, int boxHeight, std::vector<Box>* boxes);
+	int BoxCount(void);
+
+};
+
+
+#endif
\ No newline at end of file
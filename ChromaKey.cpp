@@ -0,0 +1,130 @@
+#include "ChromaKey.h"
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CHROMA_KEY_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define CHROMA_KEY_AVX2
+#include <immintrin.h>
+#endif
+
+
+/**
+\brief		Keys every row of the passed surface.
+\param[in]	surface The surface whose pixels are keyed.
+\param[in]	key The range of colors to make fully transparent.
+*/
+void ChromaKey::Apply(PixelSurface* surface, const ColorKey* key)
+{
+	for (int y = 0; y < surface->GetHeight(); y++)
+	{
+		ApplyRow(surface->GetRow(y), surface->GetWidth(), key);
+	}
+}
+
+
+/**
+\brief		Keys a row of pixels using the widest kernel available.
+\details	The vector kernels handle as many whole groups of pixels as they can and the
+			scalar kernel finishes the remaining pixels at the end of the row.
+\param[in]	row The first pixel of the row.
+\param[in]	count The number of pixels in the row.
+\param[in]	key The range of colors to make fully transparent.
+*/
+void ChromaKey::ApplyRow(unsigned int* row, int count, const ColorKey* key)
+{
+	int done = ApplyRowAvx2(row, count, key);
+	done += ApplyRowSse2(row + done, count - done, key);
+	ApplyRowScalar(row + done, count - done, key);
+}
+
+
+/**
+\brief		Keys a row of pixels one pixel at a time.
+\param[in]	row The first pixel of the row.
+\param[in]	count The number of pixels in the row.
+\param[in]	key The range of colors to make fully transparent.
+*/
+void ChromaKey::ApplyRowScalar(unsigned int* row, int count, const ColorKey* key)
+{
+	unsigned int lowR = (key->low >> 16) & 0xff, highR = (key->high >> 16) & 0xff;
+	unsigned int lowG = (key->low >> 8) & 0xff, highG = (key->high >> 8) & 0xff;
+	unsigned int lowB = key->low & 0xff, highB = key->high & 0xff;
+	for (int i = 0; i < count; i++)
+	{
+		unsigned int r = (row[i] >> 16) & 0xff;
+		unsigned int g = (row[i] >> 8) & 0xff;
+		unsigned int b = row[i] & 0xff;
+		// clear the pixel without a branch, keyed and unkeyed pixels are usually mixed along a row
+		unsigned int match = (r >= lowR) & (r <= highR) & (g >= lowG) & (g <= highG) & (b >= lowB) & (b <= highB);
+		row[i] &= match - 1;
+	}
+}
+
+
+/**
+\brief		Keys a row of pixels 4 at a time with SSE2.
+\details	Each channel is in range when clamping it to the low and high channels leaves it unchanged.
+			The alpha channel of the range is opened to 0 - 255 so only red, green and blue are tested,
+			and a pixel is cleared when all 4 of its channels are in range.
+\param[in]	row The first pixel of the row.
+\param[in]	count The number of pixels in the row.
+\param[in]	key The range of colors to make fully transparent.
+\return		The number of pixels keyed, a multiple of 4.
+*/
+#ifdef CHROMA_KEY_SSE2
+int ChromaKey::ApplyRowSse2(unsigned int* row, int count, const ColorKey* key)
+{
+	int i = 0;
+	__m128i low = _mm_set1_epi32((int)(key->low & 0x00ffffff));
+	__m128i high = _mm_set1_epi32((int)(key->high | 0xff000000));
+	__m128i ones = _mm_set1_epi32(-1);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i pixels = _mm_loadu_si128((__m128i*)(row + i));
+		__m128i aboveLow = _mm_cmpeq_epi8(_mm_max_epu8(pixels, low), pixels);
+		__m128i belowHigh = _mm_cmpeq_epi8(_mm_min_epu8(pixels, high), pixels);
+		__m128i match = _mm_cmpeq_epi32(_mm_and_si128(aboveLow, belowHigh), ones);
+		_mm_storeu_si128((__m128i*)(row + i), _mm_andnot_si128(match, pixels));
+	}
+	return i;
+}
+#else
+int ChromaKey::ApplyRowSse2(unsigned int*, int, const ColorKey*)
+{
+	return 0;
+}
+#endif
+
+
+/**
+\brief		Keys a row of pixels 8 at a time with AVX2.
+\details	Uses the same clamp test as the SSE2 kernel on 256-bit registers.
+\param[in]	row The first pixel of the row.
+\param[in]	count The number of pixels in the row.
+\param[in]	key The range of colors to make fully transparent.
+\return		The number of pixels keyed, a multiple of 8.
+*/
+#ifdef CHROMA_KEY_AVX2
+int ChromaKey::ApplyRowAvx2(unsigned int* row, int count, const ColorKey* key)
+{
+	int i = 0;
+	__m256i low = _mm256_set1_epi32((int)(key->low & 0x00ffffff));
+	__m256i high = _mm256_set1_epi32((int)(key->high | 0xff000000));
+	__m256i ones = _mm256_set1_epi32(-1);
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256i pixels = _mm256_loadu_si256((__m256i*)(row + i));
+		__m256i aboveLow = _mm256_cmpeq_epi8(_mm256_max_epu8(pixels, low), pixels);
+		__m256i belowHigh = _mm256_cmpeq_epi8(_mm256_min_epu8(pixels, high), pixels);
+		__m256i match = _mm256_cmpeq_epi32(_mm256_and_si256(aboveLow, belowHigh), ones);
+		_mm256_storeu_si256((__m256i*)(row + i), _mm256_andnot_si256(match, pixels));
+	}
+	return i;
+}
+#else
+int ChromaKey::ApplyRowAvx2(unsigned int*, int, const ColorKey*)
+{
+	return 0;
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,33 @@
+#include "PixelSurface.h"
+
+
+#ifndef __CHROMA_KEY_H__
+#define __CHROMA_KEY_H__
+
+
+/**
+\class		ChromaKey
+\author		Tom Bisch
+\date		Apr 26, 2016
+\brief		Turns the pixels of a PixelSurface that fall inside a color key range fully transparent.
+\details	This is a static class holding the chroma key kernels. The surface is scanned row by row 
+			on the raw pixel memory, comparing 8 pixels at a time with AVX2 or 4 pixels at a time with 
+			SSE2 when the compiler targets them, and one pixel at a time otherwise. An exact color is
+			keyed by passing a ColorKey whose low and high colors are the same.
+*/
+class ChromaKey
+{
+
+private:
+	static void ApplyRowScalar(unsigned int* row, int count, const ColorKey* key);
+	static int ApplyRowSse2(unsigned int* row, int count, const ColorKey* key);
+	static int ApplyRowAvx2(unsigned int* row, int count, const ColorKey* key);
+
+public:
+	static void Apply(PixelSurface* surface, const ColorKey* key);
+	static void ApplyRow(unsigned int* row, int count, const ColorKey* key);
+
+};
+
+
+#endif
\ No newline at end of file
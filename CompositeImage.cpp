@@ -1,4 +1,9 @@
 #include "CompositeImage.h"
+#include <utility>
+
+
+// class constants
+const int CompositeImage::INVALID_HANDLE = -1;
 
 
 /**
@@ -10,6 +15,9 @@ CompositeImage::CompositeImage(void)
 	yPos = 0;
 	width = 0;
 	height = 0;
+	rotation = 0;
+	isCached = false;
+	isCacheValid = false;
 }
 
 
@@ -23,82 +31,136 @@ CompositeImage::~CompositeImage(void)
 
 /**
 \brief		Adds a BitmapImage object to the CompositeImage instance.
-\details	The BitmapImage is added to the list of BitmapImages, whose bitmaps are all combined 
+\details	The BitmapImage is moved into the vector of BitmapImages, whose bitmaps are all combined 
 			and drawn to a window when the CompositeImage instance's Draw method is called.
 \param[in]	bitmap The BitmapImage to add to the CompositeImage.
+\return		The handle used to draw or get the added BitmapImage.
 */
-void CompositeImage::AddImage(BitmapImage bitmap)
+int CompositeImage::AddImage(BitmapImage bitmap)
 {
-	bitmaps.push_back(bitmap);
+	handles.push_back(bitmaps.size());
+	bitmaps.push_back(std::move(bitmap));
 	CalculateDimensions();
+	InvalidateCache();
+	return handles.size() - 1;
 }
 
 
 /**
 \brief		Removes a BitmapImage object from the CompositeImage instance.
-\details	The BitmapImage is removed from the list of BitmapImage objects and its bitmap will no longer be drawn.
+\details	The BitmapImage is removed from the vector of BitmapImage objects and its bitmap will no longer be drawn.
+			Its handle is not reused, drawing with it afterwards draws nothing.
 \param[in]	bitmapName The name identifier of the BitmapImage to remove.
 \return		Returns true if the BitmapImage was found, false otherwise.
 */
 bool CompositeImage::RemoveImage(wstring bitmapName)
 {
-	bool isFound = false;
-	std::list<BitmapImage>::iterator i = bitmaps.begin();
-	while (i != bitmaps.end() && isFound == false)
+	int handle = FindImage(bitmapName);
+	if (handle == INVALID_HANDLE)
 	{
-		if (i->GetName() == bitmapName)
+		return false;
+	}
+	// the BitmapImages after the removed one move down, so their handles must follow
+	int index = handles[handle];
+	bitmaps.erase(bitmaps.begin() + index);
+	handles[handle] = INVALID_HANDLE;
+	for (unsigned int i = 0; i < handles.size(); i++)
+	{
+		if (handles[i] > index)
 		{
-			bitmaps.erase(i);
-			isFound = true;
-			CalculateDimensions();
+			handles[i]--;
 		}
-		i++;
 	}
-	return isFound;
+	CalculateDimensions();
+	InvalidateCache();
+	return true;
 }
 
 
 /**
-\brief		Draws the CompositeImage to the window using the passed Gdiplus::Graphics pointer.
+\brief		Draws the CompositeImage onto the passed target surface.
 \details	Loops through all the BitmapImage objects contained within the CompositeImage and draws
-			their bitmaps to the window using the passed pointer to the graphics object.
-\param[in]	g The pointer to the graphics object used to draw to the window.
-\param[in]	ia The pointer to the image attributes object used to specify draw attributes.
+			their bitmaps onto the target surface. If the CompositeImage is cached and no color key is
+			passed, the flattened cache is copied onto the target instead, rebuilding it first if it
+			has been invalidated.
+\param[in]	target The surface to draw onto, normally the window's back buffer.
+\param[in]	key The range of colors to draw as transparent, or NULL to draw every pixel.
+*/
+void CompositeImage::Draw(PixelSurface* target, const ColorKey* key)
+{
+	if (isCached == true && key == NULL && rotation == 0)
+	{
+		if (isCacheValid == false)
+		{
+			BuildCache();
+		}
+		target->Copy(&cache, xPos, yPos);
+		return;
+	}
+	for (unsigned int i = 0; i < bitmaps.size(); i++)
+	{
+		bitmaps[i].Draw(target, key);
+	}
+}
+
+
+/**
+\brief		Draws a single bitmap of a CompositeImage onto the passed target surface.
+\details	The bitmap is looked up by the handle returned from AddImage, so no names are compared.
+\param[in]	target The surface to draw onto, normally the window's back buffer.
+\param[in]	handle The handle of the BitmapImage whose bitmap should be drawn to the window.
+\param[in]	key The range of colors to draw as transparent, or NULL to draw every pixel.
+\return		Returns true if the handle belongs to a BitmapImage in the CompositeImage, false otherwise.
 */
-void CompositeImage::Draw(Gdiplus::Graphics* g, Gdiplus::ImageAttributes* ia)
+bool CompositeImage::DrawSingle(PixelSurface* target, int handle, const ColorKey* key)
 {
-	std::list<BitmapImage>::iterator i = bitmaps.begin();
-	while (i != bitmaps.end())
+	BitmapImage* bitmapImage = GetBitmapImage(handle);
+	if (bitmapImage == NULL)
 	{
-		i->Draw(g, ia);
-		i++;
+		return false;
 	}
+	bitmapImage->Draw(target, key);
+	return true;
 }
 
 
 /**
-\brief		Draws a single bitmap of a CompositeImage to the window using the passed Gdiplus::Graphics pointer.
-\details	Loops through all the BitmapImage objects contained within the CompositeImage 
-			to find the single bitmap specified by the bitmapName parameter. If the bitmap
-			is found, it is drawn to the window using the passed pointer to the graphics object.
-\param[in]	g The pointer to the graphics object used to draw to the window.
-\param[in]	bitmapName The name of the bitmapImage whose bitmap should be drawn to the window.
-\param[in]	ia The pointer to the image attributes object used to specify draw attributes.
+\brief		Builds everything the next Draw without a color key would build on first use.
+\details	Rebuilds the flattened cache if it has been invalidated and the CompositeImage draws from it,
+			and otherwise prepares every BitmapImage. The CompositeImage can then be drawn onto several 
+			parts of a surface by different threads until it is next changed.
 */
-bool CompositeImage::DrawSingle(Gdiplus::Graphics* g, wstring bitmapName, Gdiplus::ImageAttributes* ia)
+void CompositeImage::Prepare(void)
 {
-	bool isFound = false;
-	std::list<BitmapImage>::iterator i = bitmaps.begin();
-	while (i != bitmaps.end() && isFound == false)
+	if (isCached == true && rotation == 0)
 	{
-		if (i->GetName() == bitmapName)
+		if (isCacheValid == false)
 		{
-			i->Draw(g, ia);
-			isFound = true;
+			BuildCache();
 		}
-		i++;
+		return;
+	}
+	for (unsigned int i = 0; i < bitmaps.size(); i++)
+	{
+		bitmaps[i].Prepare(bitmaps[i].GetRotation());
 	}
-	return isFound;
+}
+
+
+/**
+\brief		Returns the flattened cache the CompositeImage is drawn from without a color key.
+\details	The cache is rebuilt first if it has been invalidated. It stays valid until the
+			CompositeImage is next changed.
+\return		The cache, or NULL if the CompositeImage is drawn bitmap by bitmap.
+*/
+const PixelSurface* CompositeImage::GetCache(void)
+{
+	if (isCached == false || rotation != 0)
+	{
+		return NULL;
+	}
+	Prepare();
+	return &cache;
 }
 
 
@@ -114,13 +176,30 @@ bool CompositeImage::DrawSingle(Gdiplus::Graphics* g, wstring bitmapName, Gdiplu
 */
 void CompositeImage::Resize(double width, double height, bool scaleDimensions)
 {
-	std::list<BitmapImage>::iterator i = bitmaps.begin();
-	while (i != bitmaps.end())
+	for (unsigned int i = 0; i < bitmaps.size(); i++)
 	{
-		i->Resize(width, height, scaleDimensions);
-		i++;
+		bitmaps[i].Resize(width, height, scaleDimensions);
 	}
 	CalculateDimensions();
+	InvalidateCache();
+}
+
+
+/**
+\brief		Describes the surfaces a later call to Resize with the same parameters will need.
+\details	Loops through each BitmapImage object and calls its RequestResize method. Nothing about 
+			the CompositeImage changes.
+\param[in]	width The width of the resized bitmap.
+\param[in]	height The height of the resized bitmap.
+\param[in]	scaleDimensions Indicates if the width and height parameters are exact or scalar values.
+\param[out]	requests The list the requests for the scaled surfaces are added to.
+*/
+void CompositeImage::RequestResize(double width, double height, bool scaleDimensions, std::vector<ImageRequest>* requests)
+{
+	for (unsigned int i = 0; i < bitmaps.size(); i++)
+	{
+		bitmaps[i].RequestResize(width, height, scaleDimensions, requests);
+	}
 }
 
 
@@ -133,11 +212,10 @@ void CompositeImage::Rotate(int degrees)
 {
 	// make degrees a positive value from 0 - 360 
 	rotation = degrees % 360;
-	std::list<BitmapImage>::iterator i = bitmaps.begin();
-	while (i != bitmaps.end())
+	InvalidateCache();
+	for (unsigned int i = 0; i < bitmaps.size(); i++)
 	{
-		i->Rotate(rotation);
-		i++;
+		bitmaps[i].Rotate(rotation);
 	}
 }
 
@@ -149,17 +227,137 @@ void CompositeImage::Rotate(int degrees)
 */
 void CompositeImage::MoveTo(int x, int y)
 {
+	if (x != xPos || y != yPos)
+	{
+		InvalidateCache();
+	}
 	xPos = x;
 	yPos = y;
-	std::list<BitmapImage>::iterator i = bitmaps.begin();
-	while (i != bitmaps.end())
+	for (unsigned int i = 0; i < bitmaps.size(); i++)
+	{
+		bitmaps[i].MoveTo(x, y);
+	}
+}
+
+
+/**
+\brief		Bakes a range of colors into the alpha channel of each BitmapImage after every resize.
+\details	Loops through each BitmapImage object and calls its SetColorKey method, so the
+			CompositeImage can be drawn without a color key.
+\param[in]	key The range of colors to make fully transparent, or NULL to stop keying.
+*/
+void CompositeImage::SetColorKey(const ColorKey* key)
+{
+	for (unsigned int i = 0; i < bitmaps.size(); i++)
+	{
+		bitmaps[i].SetColorKey(key);
+	}
+	InvalidateCache();
+}
+
+
+/**
+\brief		Sets the filter used to resize each BitmapImage.
+\details	Loops through each BitmapImage object and calls its SetFilter method.
+\param[in]	filter The filter to resize with.
+*/
+void CompositeImage::SetFilter(Resampler::Filter filter)
+{
+	for (unsigned int i = 0; i < bitmaps.size(); i++)
+	{
+		bitmaps[i].SetFilter(filter);
+	}
+	InvalidateCache();
+}
+
+
+/**
+\brief		Sets if each BitmapImage is resized from a chain of mipmaps.
+\details	Loops through each BitmapImage object and calls its SetMipmapped method.
+\param[in]	mipmapped Indicates if the bitmaps should be resized from mipmaps.
+*/
+void CompositeImage::SetMipmapped(bool mipmapped)
+{
+	for (unsigned int i = 0; i < bitmaps.size(); i++)
+	{
+		bitmaps[i].SetMipmapped(mipmapped);
+	}
+	InvalidateCache();
+}
+
+
+/**
+\brief		Sets if each BitmapImage is drawn rotated from a cache of pre-rotated frames.
+\details	Loops through each BitmapImage object and calls its SetRotationCached method.
+\param[in]	cached Indicates if rotations should be drawn from the cache.
+*/
+void CompositeImage::SetRotationCached(bool cached)
+{
+	for (unsigned int i = 0; i < bitmaps.size(); i++)
+	{
+		bitmaps[i].SetRotationCached(cached);
+	}
+}
+
+
+/**
+\brief		Sets if unrotated draws of each BitmapImage use spans of its solid pixels.
+\details	Loops through each BitmapImage object and calls its SetSpanEncoded method.
+\param[in]	encoded Indicates if the drawn surfaces should be encoded into spans.
+*/
+void CompositeImage::SetSpanEncoded(bool encoded)
+{
+	for (unsigned int i = 0; i < bitmaps.size(); i++)
+	{
+		bitmaps[i].SetSpanEncoded(encoded);
+	}
+}
+
+
+/**
+\brief		Sets if a hit mask is kept for each BitmapImage.
+\details	Loops through each BitmapImage object and calls its SetHitTested method.
+\param[in]	tested Indicates if the hit masks should be built.
+*/
+void CompositeImage::SetHitTested(bool tested)
+{
+	for (unsigned int i = 0; i < bitmaps.size(); i++)
 	{
-		i->MoveTo(x, y);
-		i++;
+		bitmaps[i].SetHitTested(tested);
 	}
 }
 
 
+/**
+\brief		Sets if the CompositeImage is drawn from a flattened cache of its bitmaps.
+\details	A cached CompositeImage draws all of its bitmaps once onto a single opaque surface and 
+			copies that surface onto the target every time it is drawn, until the cache is invalidated 
+			by Resize, Rotate, MoveTo, SetColorKey, AddImage or RemoveImage. This suits images that 
+			rarely change, like the background. Because the cache is opaque, it replaces whatever is 
+			underneath, so a cached CompositeImage should be the first thing drawn in a frame.
+\param[in]	cached Indicates if the CompositeImage should be drawn from the cache.
+*/
+void CompositeImage::SetCached(bool cached)
+{
+	isCached = cached;
+	if (isCached == false)
+	{
+		cache.Release();
+	}
+	InvalidateCache();
+}
+
+
+/**
+\brief		Marks the cache as out of date so it is rebuilt the next time the CompositeImage is drawn.
+\details	Must be called after changing a BitmapImage returned by GetBitmapImage.
+*/
+void CompositeImage::InvalidateCache(void)
+{
+	isCacheValid = false;
+}
+
+
 /**
 \brief		Counts and returns the number of BitmapImages within the CompositeImage instance.
 \return		The number of BitmapImages contained in the CompositeImage.
@@ -170,27 +368,65 @@ int CompositeImage::BitmapImageCount(void)
 }
 
 
+/**
+\brief		Returns the handle of the BitmapImage specified by the bitmapName parameter value.
+\details	Compares the name of every BitmapImage, so it is meant for setup code rather than
+			for every frame.
+\param[in]  bitmapName The name identifier of the BitmapImage to find.
+\return		Returns the handle of the BitmapImage if found, otherwise INVALID_HANDLE is returned.
+*/
+int CompositeImage::FindImage(wstring bitmapName)
+{
+	for (unsigned int i = 0; i < handles.size(); i++)
+	{
+		if (handles[i] != INVALID_HANDLE && bitmaps[handles[i]].GetName() == bitmapName)
+		{
+			return i;
+		}
+	}
+	return INVALID_HANDLE;
+}
+
+
+/**
+\brief		Returns the BitmapImage object specified by the handle returned from AddImage.
+\param[in]  handle The handle of the BitmapImage to return.
+\return		Returns the BitmapImage if the handle is valid, otherwise NULL is returned.
+*/
+BitmapImage* CompositeImage::GetBitmapImage(int handle)
+{
+	if (handle < 0 || handle >= (int)handles.size() || handles[handle] == INVALID_HANDLE)
+	{
+		return NULL;
+	}
+	return &bitmaps[handles[handle]];
+}
+
+
 /**
 \brief		Returns the BitmapImage object specified by the bitmapName parameter value.
-\details	Loops through the BitmapImages contained within the CompositeImage and checks if the 
-			specified bitmapName belongs to any of its BitmapImages, if so, the BitmapImage is returned.
+\details	Looks up the handle of the BitmapImage with FindImage, so it is meant for setup code 
+			rather than for every frame.
 \param[in]  bitmapName The name identifier of the BitmapImage to return.
 \return		Returns the BitmapImage if found, otherwise NULL is returned.
 */
 BitmapImage* CompositeImage::GetBitmapImage(wstring bitmapName)
 {
-	BitmapImage* bitmapImage = NULL;
-	std::list<BitmapImage>::iterator i = bitmaps.begin();
-	while (i != bitmaps.end())
+	return GetBitmapImage(FindImage(bitmapName));
+}
+
+
+/**
+\brief		Adds a pointer to each BitmapImage to the passed list, in drawing order.
+\details	The pointers stay valid until a BitmapImage is added to or removed from the CompositeImage.
+\param[out]	list The list to add the BitmapImages to.
+*/
+void CompositeImage::GetBitmapImages(std::vector<BitmapImage*>* list)
+{
+	for (unsigned int i = 0; i < bitmaps.size(); i++)
 	{
-		if (i->GetName() == bitmapName)
-		{
-			bitmapImage = &i._Ptr->_Myval;
-			break;
-		}
-		i++;
+		list->push_back(&bitmaps[i]);
 	}
-	return bitmapImage;
 }
 
 
@@ -253,19 +489,34 @@ void CompositeImage::CalculateDimensions(void)
 {
 	int w = 0;
 	int h = 0;
-	std::list<BitmapImage>::iterator i = bitmaps.begin();
-	while (i != bitmaps.end())
+	for (unsigned int i = 0; i < bitmaps.size(); i++)
 	{
-		if (i->GetBitmap()->GetWidth() > (unsigned)w)
+		if (bitmaps[i].GetWidth() > w)
 		{
-			w = i->GetBitmap()->GetWidth();
+			w = bitmaps[i].GetWidth();
 		}
-		if (i->GetBitmap()->GetHeight() > (unsigned)h)
+		if (bitmaps[i].GetHeight() > h)
 		{
-			h = i->GetBitmap()->GetHeight();
+			h = bitmaps[i].GetHeight();
 		}
-		i++;
 	}
 	width = w;
 	height = h;
+}
+
+
+/**
+\brief		Flattens all the bitmaps of the CompositeImage onto the cache.
+\details	The cache is cleared to opaque black, the same as a new back buffer, and each bitmap
+			is drawn onto it at its position relative to the CompositeImage.
+*/
+void CompositeImage::BuildCache(void)
+{
+	cache.Create(width, height);
+	cache.Clear(PixelSurface::MakeArgb(255, 0, 0, 0));
+	for (unsigned int i = 0; i < bitmaps.size(); i++)
+	{
+		cache.Blend(bitmaps[i].GetSurface(), bitmaps[i].GetXPos() - xPos, bitmaps[i].GetYPos() - yPos);
+	}
+	isCacheValid = true;
 }
\ No newline at end of file
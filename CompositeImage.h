@@ -1,9 +1,7 @@
 #include "BitmapImage.h"
-#include <windows.h>
-#include <gdiplus.h>
+#include "PixelSurface.h"
 #include <string>
-#include <list>
-using namespace Gdiplus;
+#include <vector>
 using namespace std;
 
 
@@ -20,31 +18,51 @@ using namespace std;
 			combined into a single image when drawn onto a device context. This class contains methods 
 			to add and remove BitmapImage objects from a CompositeImage objects as well as methods that 
 			allow all the bitmaps contained within to be repositioned and scaled. 
+			Each BitmapImage added is given an integer handle that stays valid until it is removed,
+			so a single bitmap can be drawn every frame without searching for it by name.
 */
 class CompositeImage 
 {
 
 private:
-	std::list<BitmapImage> bitmaps;		// the bitmaps combined to make a composite image
+	std::vector<BitmapImage> bitmaps;	// the bitmaps combined to make a composite image, in drawing order
+	std::vector<int> handles;			// the index in bitmaps of each handle, INVALID_HANDLE once removed
 	int xPos;							// the X coordinate to draw all the bitmaps
 	int yPos;							// the Y coordinate to draw all the bitmaps
 	int width;							// the width of the widest bitmap
 	int height;							// the height of the highest bitmap
 	int rotation;						// the rotation at which to draw all the bitmaps
+	PixelSurface cache;					// all the bitmaps flattened onto a single opaque surface
+	bool isCached;						// indicates if the CompositeImage is drawn from the cache
+	bool isCacheValid;					// indicates if the cache matches the bitmaps
 
 	void CalculateDimensions(void);
+	void BuildCache(void);
 
 public:
+	static const int INVALID_HANDLE;	// handle of a BitmapImage that is not in the CompositeImage
+
 	CompositeImage(void);
 	~CompositeImage(void);
 
-	void AddImage(BitmapImage bitmap);
+	int AddImage(BitmapImage bitmap);
 	bool RemoveImage(wstring bitmapName);
-	void Draw(Gdiplus::Graphics* g, Gdiplus::ImageAttributes* ia = NULL);
-	bool DrawSingle(Gdiplus::Graphics* g, wstring bitmapName, Gdiplus::ImageAttributes* ia = NULL);
+	void Draw(PixelSurface* target, const ColorKey* key = NULL);
+	bool DrawSingle(PixelSurface* target, int handle, const ColorKey* key = NULL);
+	void Prepare(void);
+	const PixelSurface* GetCache(void);
 	void Resize(double width, double height, bool scaleDimensions = false);
+	void RequestResize(double width, double height, bool scaleDimensions, std::vector<ImageRequest>* requests);
 	void Rotate(int degrees);
 	void MoveTo(int x, int y);
+	void SetColorKey(const ColorKey* key);
+	void SetFilter(Resampler::Filter filter);
+	void SetMipmapped(bool mipmapped);
+	void SetRotationCached(bool cached);
+	void SetSpanEncoded(bool encoded);
+	void SetHitTested(bool tested);
+	void SetCached(bool cached);
+	void InvalidateCache(void);
 	int BitmapImageCount(void);
 
 	int GetXPos(void);
@@ -52,7 +70,10 @@ public:
 	int GetWidth(void);
 	int GetHeight(void);
 	int GetRotation(void);
+	int FindImage(wstring bitmapName);
+	BitmapImage* GetBitmapImage(int handle);
 	BitmapImage* GetBitmapImage(wstring bitmapName);
+	void GetBitmapImages(std::vector<BitmapImage*>* list);
 
 };
 
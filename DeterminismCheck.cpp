@@ -0,0 +1,172 @@
+/**
+\file		DeterminismCheck.cpp
+\author		Tom Bisch
+\date		Jun 10, 2016
+\brief		Checks that a game plays exactly the same whatever the number of threads solving its boxes.
+\details	The same seeded games are played without a ThreadPool and then with pools of 1 to 8 threads,
+			and the positions of every box and the scores are hashed after every frame. The games stand
+			rows of towers across a wide world and keep knocking them down by shrinking the world, so
+			there are enough awake boxes to split into islands, and falling boxes are thrown sideways so
+			the islands crowd each other. Every run must give the same hash as the run without a pool.
+			Debug builds also check that no box is reached from two islands in the same timestep.
+
+			Usage: DeterminismCheck [frames]
+*/
+
+
+// include files
+#include "World.h"
+#include "ThreadPool.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+using namespace std;
+
+
+// constants
+const int GAME_COUNT = 3;					// the number of seeded games played by each run
+const unsigned long DEFAULT_FRAMES = 600;		// the number of frames of each game when none are passed
+const int MAX_THREADS = 8;					// the most threads the boxes are solved on
+
+
+// prototypes
+unsigned long long PlayGames(ThreadPool* pool, unsigned long frames);
+string BuildTowers(unsigned int* random, int towerCount);
+unsigned int NextRandom(unsigned int* random);
+void Hash(unsigned long long* hash, long long value);
+
+
+/**
+\brief		Plays the games without a pool and with every pool size and compares their hashes.
+\param[in]	argc The number of command line arguments.
+\param[in]	argv The command line arguments: the number of frames of each game.
+\return		0 if every run gave the same hash, 1 if any run differed.
+*/
+int main(int argc, char** argv)
+{
+	unsigned long frames = argc > 1 ? strtoul(argv[1], NULL, 10) : DEFAULT_FRAMES;
+
+	unsigned long long expected = PlayGames(NULL, frames);
+	printf("no pool:    %016llx\n", expected);
+	int failures = 0;
+	for (int threads = 1; threads <= MAX_THREADS; threads++)
+	{
+		ThreadPool pool(threads);
+		unsigned long long hash = PlayGames(&pool, frames);
+		printf("%d thread%s:  %016llx%s\n", threads, threads == 1 ? " " : "s", hash, hash == expected ? "" : "  DIFFERS");
+		failures += hash != expected ? 1 : 0;
+	}
+	return failures == 0 ? 0 : 1;
+}
+
+
+/**
+\brief		Plays every seeded game and hashes the boxes and scores after every frame.
+\param[in]	pool The threads the boxes are solved on, or NULL to solve them on the calling thread.
+\param[in]	frames The number of frames of each game.
+\return		The hash of every frame of every game.
+*/
+unsigned long long PlayGames(ThreadPool* pool, unsigned long frames)
+{
+	unsigned long long hash = 1469598103934665603ULL;
+	for (int game = 1; game <= GAME_COUNT; game++)
+	{
+		unsigned int random = game;
+		World world(6000, 1200, game);
+		world.SetThreadPool(pool);
+		world.SetBoxSize(24, 24);
+		world.LoadStructure(BuildTowers(&random, 30 + game * 5));
+
+		for (unsigned long i = 0; i < frames; i++)
+		{
+			world.Step();
+
+			// shoot at the reptile now and then, so it falls onto the towers
+			Reptile* reptile = world.GetReptile();
+			if (NextRandom(&random) % 40 == 0)
+			{
+				world.Shoot(reptile->GetXPos() + reptile->GetWidth() / 2, reptile->GetYPos() + reptile->GetHeight() / 2);
+			}
+			// throw some of the falling boxes sideways, towards the boxes of the other islands
+			for (int b = 0; b < world.BoxCount(); b++)
+			{
+				Box* box = world.GetBox(b);
+				if (box->GetYVel() != 0 && NextRandom(&random) % 7 == 0)
+				{
+					box->SetXVel((int)(NextRandom(&random) % 31) - 15);
+				}
+			}
+			// lowering the ground drops every box, which wakes the whole world
+			if (i % 500 == 250)
+			{
+				world.Resize(world.GetWidth(), world.GetHeight() - 150);
+			}
+
+			Scoreboard* scoreboard = world.GetScoreboard();
+			Hash(&hash, reptile->GetXPos());
+			Hash(&hash, reptile->GetYPos());
+			Hash(&hash, scoreboard->GetTotalScore());
+			Hash(&hash, scoreboard->GetRoundScore());
+			for (int b = 0; b < world.BoxCount(); b++)
+			{
+				Hash(&hash, world.GetBox(b)->GetXPos());
+				Hash(&hash, world.GetBox(b)->GetYPos());
+			}
+		}
+	}
+	return hash;
+}
+
+
+/**
+\brief		Describes a row of towers of random heights, spread evenly across the world.
+\param[in,out]	random The state of the random number generator.
+\param[in]	towerCount The number of towers.
+\return		The BoxStructure description of the towers.
+*/
+string BuildTowers(unsigned int* random, int towerCount)
+{
+	string description;
+	for (int t = 0; t < towerCount; t++)
+	{
+		char line[32];
+		snprintf(line, sizeof(line), "at %f\n", t * 0.97 / towerCount);
+		description += line;
+		int rows = 6 + NextRandom(random) % 20;
+		for (int r = 0; r < rows; r++)
+		{
+			string row = NextRandom(random) % 2 == 0 ? "" : " ";
+			int columns = 1 + NextRandom(random) % 2;
+			for (int c = 0; c < columns; c++)
+			{
+				row += NextRandom(random) % 4 == 0 ? ".." : "[]";
+			}
+			description += row + "\n";
+		}
+	}
+	return description;
+}
+
+
+/**
+\brief		Returns the next number of a linear congruential generator, the same on every platform.
+\param[in,out]	random The state of the generator.
+\return		A number from 0 to 32767.
+*/
+unsigned int NextRandom(unsigned int* random)
+{
+	*random = *random * 1103515245 + 12345;
+	return (*random >> 16) & 0x7FFF;
+}
+
+
+/**
+\brief		Mixes a value into an FNV-1a hash.
+\param[in,out]	hash The hash.
+\param[in]	value The value mixed in.
+*/
+void Hash(unsigned long long* hash, long long value)
+{
+	*hash ^= (unsigned long long)value;
+	*hash *= 1099511628211ULL;
+}
\ No newline at end of file
@@ -0,0 +1,231 @@
+#include "DirtyRegion.h"
+
+
+// class constants
+const int DirtyRegion::MAX_RECTS = 16;
+const int DirtyRegion::FULL_PERCENT = 60;
+
+
+/**
+\brief		Constructs an empty DirtyRegion object with no bounds.
+*/
+DirtyRegion::DirtyRegion(void)
+{
+	width = 0;
+	height = 0;
+}
+
+
+/**
+\brief		Destructor for a DirtyRegion. Currently does nothing.
+*/
+DirtyRegion::~DirtyRegion(void)
+{
+}
+
+
+/**
+\brief		Sets the size of the window the rectangles are clipped to.
+\details	Changing the bounds marks the whole window as changed.
+\param[in]	regionWidth The width of the window.
+\param[in]	regionHeight The height of the window.
+*/
+void DirtyRegion::SetBounds(int regionWidth, int regionHeight)
+{
+	width = regionWidth;
+	height = regionHeight;
+	AddAll();
+}
+
+
+/**
+\brief		Adds a changed rectangle to the DirtyRegion.
+\details	The rectangle is clipped to the window and merged with every rectangle it overlaps. 
+			If that leaves more than MAX_RECTS rectangles, the two rectangles whose union adds 
+			the least area are merged. If the rectangles then cover more than FULL_PERCENT of 
+			the window, they are replaced by the whole window.
+\param[in]	rect The rectangle that changed.
+*/
+void DirtyRegion::Add(PixelRect rect)
+{
+	// clip the rectangle to the window
+	PixelRect bounds = { 0, 0, width, height };
+	if (Overlaps(&rect, &bounds) == false)
+	{
+		return;
+	}
+	int right = rect.x + rect.width < width ? rect.x + rect.width : width;
+	int bottom = rect.y + rect.height < height ? rect.y + rect.height : height;
+	rect.x = rect.x > 0 ? rect.x : 0;
+	rect.y = rect.y > 0 ? rect.y : 0;
+	rect.width = right - rect.x;
+	rect.height = bottom - rect.y;
+
+	// merge with overlapping rectangles until none overlap,
+	// restarting the search because a union can overlap rectangles that were checked earlier
+	unsigned int i = 0;
+	while (i < rects.size())
+	{
+		if (Overlaps(&rect, &rects[i]) == true)
+		{
+			rect = Union(&rect, &rects[i]);
+			rects.erase(rects.begin() + i);
+			i = 0;
+		}
+		else
+		{
+			i++;
+		}
+	}
+	rects.push_back(rect);
+
+	// merge the closest pair of rectangles if there are too many
+	if (rects.size() > (unsigned)MAX_RECTS)
+	{
+		int bestA = 0;
+		int bestB = 1;
+		int bestWaste = -1;
+		for (unsigned int a = 0; a < rects.size(); a++)
+		{
+			for (unsigned int b = a + 1; b < rects.size(); b++)
+			{
+				PixelRect merged = Union(&rects[a], &rects[b]);
+				int waste = Area(&merged) - Area(&rects[a]) - Area(&rects[b]);
+				if (bestWaste < 0 || waste < bestWaste)
+				{
+					bestA = a;
+					bestB = b;
+					bestWaste = waste;
+				}
+			}
+		}
+		PixelRect merged = Union(&rects[bestA], &rects[bestB]);
+		rects.erase(rects.begin() + bestB);
+		rects.erase(rects.begin() + bestA);
+		Add(merged);
+	}
+
+	// redraw the whole window if most of it changed
+	if ((long long)GetArea() * 100 > (long long)width * height * FULL_PERCENT)
+	{
+		AddAll();
+	}
+}
+
+
+/**
+\brief		Marks the whole window as changed.
+*/
+void DirtyRegion::AddAll(void)
+{
+	rects.clear();
+	if (width > 0 && height > 0)
+	{
+		PixelRect all = { 0, 0, width, height };
+		rects.push_back(all);
+	}
+}
+
+
+/**
+\brief		Removes all the rectangles, after they have been redrawn and presented.
+*/
+void DirtyRegion::Clear(void)
+{
+	rects.clear();
+}
+
+
+/**
+\brief		Returns the number of changed rectangles.
+\return		The number of rectangles in the DirtyRegion.
+*/
+int DirtyRegion::RectCount(void)
+{
+	return rects.size();
+}
+
+
+/**
+\brief		Returns the changed rectangle at the passed index.
+\param[in]	index The index of the rectangle, from 0 to RectCount() - 1.
+\return		A pointer to the rectangle.
+*/
+PixelRect* DirtyRegion::GetRect(int index)
+{
+	return &rects[index];
+}
+
+
+/**
+\brief		Checks if any of the changed rectangles share pixels with the passed rectangle.
+\param[in]	rect The rectangle to check.
+\return		True if part of the rectangle changed.
+*/
+bool DirtyRegion::Intersects(const PixelRect* rect)
+{
+	for (unsigned int i = 0; i < rects.size(); i++)
+	{
+		if (Overlaps(rect, &rects[i]) == true)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+
+/**
+\brief		Returns the number of pixels covered by the changed rectangles.
+\return		The total area of the rectangles.
+*/
+int DirtyRegion::GetArea(void)
+{
+	int area = 0;
+	for (unsigned int i = 0; i < rects.size(); i++)
+	{
+		area += Area(&rects[i]);
+	}
+	return area;
+}
+
+
+/**
+\brief		Checks if two rectangles share any pixels.
+\param[in]	a The first rectangle.
+\param[in]	b The second rectangle.
+\return		True if the rectangles overlap.
+*/
+bool DirtyRegion::Overlaps(const PixelRect* a, const PixelRect* b)
+{
+	return a->x < b->x + b->width && b->x < a->x + a->width &&
+		a->y < b->y + b->height && b->y < a->y + a->height;
+}
+
+
+/**
+\brief		Returns the smallest rectangle containing both passed rectangles.
+\param[in]	a The first rectangle.
+\param[in]	b The second rectangle.
+\return		The union of the rectangles.
+*/
+PixelRect DirtyRegion::Union(const PixelRect* a, const PixelRect* b)
+{
+	int left = a->x < b->x ? a->x : b->x;
+	int top = a->y < b->y ? a->y : b->y;
+	int right = a->x + a->width > b->x + b->width ? a->x + a->width : b->x + b->width;
+	int bottom = a->y + a->height > b->y + b->height ? a->y + a->height : b->y + b->height;
+	PixelRect rect = { left, top, right - left, bottom - top };
+	return rect;
+}
+
+
+/**
+\brief		Returns the number of pixels in a rectangle.
+\param[in]	rect The rectangle.
+\return		The area of the rectangle.
+*/
+int DirtyRegion::Area(const PixelRect* rect)
+{
+	return rect->width * rect->height;
+}
\ No newline at end of file
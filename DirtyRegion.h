@@ -0,0 +1,51 @@
+#include "PixelSurface.h"
+#include <vector>
+using namespace std;
+
+
+#ifndef __DIRTY_REGION_H__
+#define __DIRTY_REGION_H__
+
+
+/**
+\class		DirtyRegion
+\author		Tom Bisch
+\date		May 3, 2016
+\brief		Collects the rectangles of a window that changed since the last frame.
+\details	Rectangles are clipped to the bounds of the window as they are added, and rectangles that
+			overlap are merged, so each pixel is redrawn and presented at most once per frame. When 
+			there are too many rectangles, the pair that wastes the least area is merged, and when the
+			rectangles cover most of the window they are replaced by a single rectangle covering all of it.
+*/
+class DirtyRegion
+{
+
+private:
+	std::vector<PixelRect> rects;		// the changed rectangles, none of which overlap
+	int width;							// the width of the window
+	int height;							// the height of the window
+
+	static bool Overlaps(const PixelRect* a, const PixelRect* b);
+	static PixelRect Union(const PixelRect* a, const PixelRect* b);
+	static int Area(const PixelRect* rect);
+
+public:
+	static const int MAX_RECTS;			// the most rectangles kept before merging the closest pair
+	static const int FULL_PERCENT;		// the percentage of the window covered before redrawing all of it
+
+	DirtyRegion(void);
+	~DirtyRegion(void);
+
+	void SetBounds(int regionWidth, int regionHeight);
+	void Add(PixelRect rect);
+	void AddAll(void);
+	void Clear(void);
+	int RectCount(void);
+	PixelRect* GetRect(int index);
+	bool Intersects(const PixelRect* rect);
+	int GetArea(void);
+
+};
+
+
+#endif
\ No newline at end of file
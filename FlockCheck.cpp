@@ -0,0 +1,127 @@
+/**
+\file		FlockCheck.cpp
+\author		Tom Bisch
+\date		Jun 12, 2016
+\brief		Checks that the reptiles of a ReptileFlock move exactly like Reptile objects with the same seeds.
+\details	A flock of reptiles and one Reptile for each of them, constructed with the same seeds, are
+			updated side by side. Reptiles are shot down at random so they fall, roll and start over, and
+			the window is resized now and then so they bounce off new sides and land on a new ground. After
+			every frame the position, rotation, state and frame of every reptile of the flock must be the
+			same as its Reptile's, and the flock must reset as many reptiles as the Reptile objects did.
+
+			Usage: FlockCheck [frames]
+*/
+
+
+// include files
+#include "ReptileFlock.h"
+#include <cstdio>
+#include <cstdlib>
+using namespace std;
+
+
+// constants
+const int SEED_COUNT = 50;					// the number of reptiles, each with a seed of its own
+const int DEFAULT_FRAMES = 5000;			// the number of frames updated when none are passed
+const int REPTILE_SIZE = 133;				// the width and height of every reptile
+
+
+// prototypes
+bool IsSame(ReptileFlock* flock, int index, Reptile* reptile);
+unsigned int NextRandom(unsigned int* random);
+
+
+/**
+\brief		Updates a flock and its Reptile objects side by side and prints the number of frames that differ.
+\param[in]	argc The number of command line arguments.
+\param[in]	argv The command line arguments: the number of frames.
+\return		0 if every reptile moved the same in every frame, 1 if any differed.
+*/
+int main(int argc, char** argv)
+{
+	int frames = argc > 1 ? atoi(argv[1]) : DEFAULT_FRAMES;
+
+	ReptileFlock flock;
+	flock.SetSize(REPTILE_SIZE, REPTILE_SIZE);
+	vector<Reptile> reptiles;
+	for (int s = 0; s < SEED_COUNT; s++)
+	{
+		flock.Add(s + 1);
+		reptiles.push_back(Reptile(s + 1));
+		reptiles.back().SetSize(REPTILE_SIZE, REPTILE_SIZE);
+	}
+
+	unsigned int random = 1;
+	int windowWidth = 1280;
+	int windowHeight = 800;
+	int failures = 0;
+	for (int frame = 0; frame < frames; frame++)
+	{
+		// resize the window now and then, sometimes narrower than a reptile
+		if (NextRandom(&random) % 400 == 0)
+		{
+			windowWidth = NextRandom(&random) % 1800 + 100;
+			windowHeight = NextRandom(&random) % 1000 + 200;
+		}
+		// shoot down some of the flying reptiles
+		for (int s = 0; s < SEED_COUNT; s++)
+		{
+			if (reptiles[s].GetState() == Reptile::STATE_FLYING && NextRandom(&random) % 150 == 0)
+			{
+				reptiles[s].SetState(Reptile::STATE_FALLING);
+				flock.SetState(s, Reptile::STATE_FALLING);
+			}
+		}
+
+		int expectedResets = 0;
+		for (int s = 0; s < SEED_COUNT; s++)
+		{
+			expectedResets += reptiles[s].Update(windowWidth, windowHeight) == true ? 1 : 0;
+		}
+		int resets = flock.Update(windowWidth, windowHeight);
+
+		bool isSame = resets == expectedResets;
+		for (int s = 0; s < SEED_COUNT; s++)
+		{
+			if (IsSame(&flock, s, &reptiles[s]) == false)
+			{
+				isSame = false;
+				printf("frame %d, seed %d: %d, %d, %d degrees vs %d, %d, %d degrees\n", frame, s + 1,
+					flock.GetXPos(s), flock.GetYPos(s), flock.GetRotation(s),
+					reptiles[s].GetXPos(), reptiles[s].GetYPos(), reptiles[s].GetRotation());
+			}
+		}
+		failures += isSame == true ? 0 : 1;
+	}
+	printf("%d reptiles, %d frames, %d differences\n", SEED_COUNT, frames, failures);
+	return failures == 0 ? 0 : 1;
+}
+
+
+/**
+\brief		Checks if a reptile of a flock is where its Reptile is, turned and drawn the same way.
+\param[in]	flock The flock.
+\param[in]	index The index of the reptile in the flock.
+\param[in]	reptile The Reptile constructed with the same seed.
+\return		True if the position, rotation, state and frame are all the same.
+*/
+bool IsSame(ReptileFlock* flock, int index, Reptile* reptile)
+{
+	return flock->GetXPos(index) == reptile->GetXPos() &&
+		flock->GetYPos(index) == reptile->GetYPos() &&
+		flock->GetRotation(index) == reptile->GetRotation() &&
+		flock->GetState(index) == reptile->GetState() &&
+		flock->GetFrameToDraw(index) == reptile->GetFrameToDraw();
+}
+
+
+/**
+\brief		Returns the next number of a linear congruential generator, the same on every platform.
+\param[in,out]	random The state of the generator.
+\return		A number from 0 to 32767.
+*/
+unsigned int NextRandom(unsigned int* random)
+{
+	*random = *random * 1103515245 + 12345;
+	return (*random >> 16) & 0x7FFF;
+}
@@ -0,0 +1,33 @@
+#include "GdiSurface.h"
+#include <cstring>
+
+
+/**
+\brief		Replaces the pixels of the surface with the image in the passed file.
+\details	Decodes the file with GDI+ and copies it into the surface as premultiplied ARGB pixels.
+			On failure the surface is left empty.
+\param[in]	path The filepath of the .bmp or .png image to load.
+\return		True if the image was loaded.
+*/
+bool PixelSurface::Load(wstring path)
+{
+	Release();
+	Gdiplus::Bitmap bitmap(path.c_str());
+	if (bitmap.GetLastStatus() != Gdiplus::Ok)
+	{
+		return false;
+	}
+	Gdiplus::Rect rect(0, 0, bitmap.GetWidth(), bitmap.GetHeight());
+	Gdiplus::BitmapData data;
+	if (bitmap.LockBits(&rect, Gdiplus::ImageLockModeRead, PixelFormat32bppPARGB, &data) != Gdiplus::Ok)
+	{
+		return false;
+	}
+	Create(data.Width, data.Height);
+	for (int y = 0; y < GetHeight(); y++)
+	{
+		memcpy(GetRow(y), (BYTE*)data.Scan0 + y * data.Stride, GetWidth() * sizeof(unsigned int));
+	}
+	bitmap.UnlockBits(&data);
+	return true;
+}
\ No newline at end of file
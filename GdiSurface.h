@@ -0,0 +1,27 @@
+#include "PixelSurface.h"
+#include <windows.h>
+#include <gdiplus.h>
+using namespace Gdiplus;
+using namespace std;
+
+
+#ifndef __GDI_SURFACE_H__
+#define __GDI_SURFACE_H__
+
+
+/**
+\class		GdiSurface
+\author		Tom Bisch
+\date		Apr 19, 2016
+\brief		Connects PixelSurface objects to GDI+ on Windows.
+\details	GdiSurface.cpp holds the only part of the renderer that decodes images with GDI+: it implements
+			PixelSurface::Load, which decodes .bmp and .png image files, and PixelSurface.cpp stubs it out
+			on other platforms. Finished frames are presented to the window by RenderTarget, so the class
+			has no members of its own and only marks where the GDI+ decoding of the renderer lives.
+*/
+class GdiSurface
+{
+};
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,83 @@
+/**
+\file		HeadlessRun.cpp
+\author		Tom Bisch
+\date		Jun 10, 2016
+\brief		Fast-forwards a seeded game of Unhappy Flying Reptiles without a window and reports its speed.
+\details	A World is stepped for the passed number of frames while a seeded shooter fires at the flying
+			reptile now and then, the same way a player clicking on the window would. Nothing is drawn, so
+			the run is only limited by the game logic, and the same seed always plays the same game. The
+			final scores are printed with the number of frames stepped each second, for score validation
+			and balancing runs.
+
+			Usage: HeadlessRun [frames] [seed] [structure file]
+*/
+
+
+// include files
+#include "World.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+using namespace std;
+
+
+// constants
+const unsigned long DEFAULT_FRAMES = 10000000;		// the number of frames stepped when none are passed
+const unsigned int SHOT_CHANCE = 40;				// a shot is taken once every this many frames, on average
+
+
+/**
+\brief		Steps a seeded game for the passed number of frames and prints its scores and speed.
+\param[in]	argc The number of command line arguments.
+\param[in]	argv The command line arguments: the number of frames, the seed and a box structure file.
+\return		0 if the game was run, 1 if the structure file could not be read.
+*/
+int main(int argc, char** argv)
+{
+	unsigned long frames = argc > 1 ? strtoul(argv[1], NULL, 10) : DEFAULT_FRAMES;
+	unsigned int seed = argc > 2 ? (unsigned int)strtoul(argv[2], NULL, 10) : 1;
+
+	World world(1280, 800, seed);
+	if (argc > 3)
+	{
+		ifstream file(argv[3]);
+		stringstream description;
+		description << file.rdbuf();
+		if (file.is_open() == false || world.LoadStructure(description.str()) == false)
+		{
+			fprintf(stderr, "cannot read the box structure in %s\n", argv[3]);
+			return 1;
+		}
+	}
+
+	// the shooter has its own generator, so the shots are the same on every platform
+	unsigned int shooter = seed;
+	unsigned long shots = 0;
+	unsigned long hits = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (unsigned long i = 0; i < frames; i++)
+	{
+		world.Step();
+		shooter = shooter * 1103515245 + 12345;
+		if ((shooter >> 16) % SHOT_CHANCE == 0)
+		{
+			Reptile* reptile = world.GetReptile();
+			int result = world.Shoot(reptile->GetXPos() + reptile->GetWidth() / 2, reptile->GetYPos() + reptile->GetHeight() / 2);
+			shots += result != World::SHOT_NONE ? 1 : 0;
+			hits += result == World::SHOT_HIT ? 1 : 0;
+		}
+	}
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	Scoreboard* scoreboard = world.GetScoreboard();
+	printf("frames:       %lu\n", frames);
+	printf("shots:        %lu (%lu hits)\n", shots, hits);
+	printf("rounds:       %d\n", scoreboard->GetRound());
+	printf("total score:  %d\n", scoreboard->GetTotalScore());
+	printf("seconds:      %.3f\n", seconds);
+	printf("frames/s:     %.0f\n", seconds > 0 ? frames / seconds : 0.0);
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include "HitMask.h"
+
+
+// class constants
+const unsigned int HitMask::ALPHA_THRESHOLD = 128;
+
+
+/**
+\brief		Constructs an empty HitMask object, which contains no pixels.
+*/
+HitMask::HitMask(void)
+{
+	width = 0;
+	height = 0;
+	wordsPerRow = 0;
+}
+
+
+/**
+\brief		Destructor for a HitMask. Currently does nothing.
+*/
+HitMask::~HitMask(void)
+{
+}
+
+
+/**
+\brief		Builds the mask from the alpha channel of the passed surface.
+\param[in]	source The surface whose solid pixels are copied into the mask.
+*/
+void HitMask::Build(const PixelSurface* source)
+{
+	width = source->GetWidth();
+	height = source->GetHeight();
+	wordsPerRow = (width + 63) / 64;
+	words.assign(wordsPerRow * height, 0);
+	for (int y = 0; y < height; y++)
+	{
+		const unsigned int* row = source->GetRow(y);
+		uint64_t* bits = &words[y * wordsPerRow];
+		for (int x = 0; x < width; x++)
+		{
+			if ((row[x] >> 24) >= ALPHA_THRESHOLD)
+			{
+				bits[x >> 6] |= (uint64_t)1 << (x & 63);
+			}
+		}
+	}
+}
+
+
+/**
+\brief		Empties the mask, so that it contains no pixels.
+*/
+void HitMask::Clear(void)
+{
+	words.clear();
+	width = 0;
+	height = 0;
+	wordsPerRow = 0;
+}
+
+
+/**
+\brief		Checks if the pixel at the passed coordinates of the mask is solid.
+\param[in]	x The X coordinate of the pixel, relative to the left edge of the mask.
+\param[in]	y The Y coordinate of the pixel, relative to the top edge of the mask.
+\return		True if the pixel is inside the mask and solid.
+*/
+bool HitMask::Contains(int x, int y) const
+{
+	if (x < 0 || x >= width || y < 0 || y >= height)
+	{
+		return false;
+	}
+	return ((words[y * wordsPerRow + (x >> 6)] >> (x & 63)) & 1) != 0;
+}
+
+
+/**
+\brief		Checks if any solid pixel of the passed mask lies on a solid pixel of this mask.
+\details	Only the rows and words where the masks overlap are compared. For each word of this mask,
+			the 64 pixels of the other mask lying on it are gathered from at most two of its words with
+			a pair of shifts, so 64 pixels are compared by each AND.
+\param[in]	other The mask to test against.
+\param[in]	x The X coordinate of the other mask's left edge, relative to the left edge of this mask.
+\param[in]	y The Y coordinate of the other mask's top edge, relative to the top edge of this mask.
+\return		True if the masks have a solid pixel in common.
+*/
+bool HitMask::Overlaps(const HitMask* other, int x, int y) const
+{
+	int left = x > 0 ? x : 0;
+	int top = y > 0 ? y : 0;
+	int right = x + other->width < width ? x + other->width : width;
+	int bottom = y + other->height < height ? y + other->height : height;
+	if (left >= right || top >= bottom)
+	{
+		return false;
+	}
+
+	for (int row = top; row < bottom; row++)
+	{
+		const uint64_t* bits = &words[row * wordsPerRow];
+		for (int word = left >> 6; word <= (right - 1) >> 6; word++)
+		{
+			if ((bits[word] & other->GetBits(row - y, word * 64 - x)) != 0)
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+
+/**
+\brief		Returns the width of the mask.
+\return		The width of the mask in pixels.
+*/
+int HitMask::GetWidth(void) const
+{
+	return width;
+}
+
+
+/**
+\brief		Returns the height of the mask.
+\return		The height of the mask in pixels.
+*/
+int HitMask::GetHeight(void) const
+{
+	return height;
+}
+
+
+/**
+\brief		Checks if the mask contains no pixels.
+\return		True if the mask has not been built, or was built from an empty surface.
+*/
+bool HitMask::IsEmpty(void) const
+{
+	return words.empty();
+}
+
+
+/**
+\brief		Returns the 64 bits of a row starting at the passed X coordinate, which need not be a word boundary.
+\param[in]	y The row, which must be inside the mask.
+\param[in]	x The X coordinate of the first bit, which may be outside the mask.
+\return		The bits from x to x + 63, with the bits outside of the mask clear.
+*/
+uint64_t HitMask::GetBits(int y, int x) const
+{
+	const uint64_t* bits = &words[y * wordsPerRow];
+	// the word holding the first bit, rounding down for negative coordinates
+	int word = x >= 0 ? x >> 6 : -((63 - x) >> 6);
+	int shift = x - word * 64;
+	uint64_t low = word >= 0 && word < wordsPerRow ? bits[word] : 0;
+	uint64_t high = word + 1 >= 0 && word + 1 < wordsPerRow ? bits[word + 1] : 0;
+	if (shift == 0)
+	{
+		return low;
+	}
+	return (low >> shift) | (high << (64 - shift));
+}
\ No newline at end of file
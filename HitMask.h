@@ -0,0 +1,53 @@
+#include "PixelSurface.h"
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+
+#ifndef __HIT_MASK_H__
+#define __HIT_MASK_H__
+
+
+/**
+\class		HitMask
+\author		Tom Bisch
+\date		Jun 4, 2016
+\brief		A copy of a surface's solid pixels packed into one bit per pixel, for hit testing.
+\details	A pixel is solid when its alpha is at least ALPHA_THRESHOLD, so clicks on the transparent
+			corners and faint antialiased edges of a sprite miss it. Each row is packed into 64-bit
+			words, the first pixel of the row in the lowest bit of the first word, and the bits past
+			the width of the surface are always clear. Testing a point reads a single bit, and testing
+			two masks for overlap shifts one mask's words into line with the other's and ANDs 64 pixels
+			at a time. The mask is a copy, so it stays valid after the surface is freed, but it must
+			be built again whenever the surface changes.
+*/
+class HitMask
+{
+
+private:
+	std::vector<uint64_t> words;		// the bits of every row, row by row
+	int width;							// the width of the mask in pixels
+	int height;							// the height of the mask in pixels
+	int wordsPerRow;					// the number of words in each row
+
+	uint64_t GetBits(int y, int x) const;
+
+public:
+	static const unsigned int ALPHA_THRESHOLD;	// the lowest alpha of a solid pixel
+
+	HitMask(void);
+	~HitMask(void);
+
+	void Build(const PixelSurface* source);
+	void Clear(void);
+	bool Contains(int x, int y) const;
+	bool Overlaps(const HitMask* other, int x, int y) const;
+
+	int GetWidth(void) const;
+	int GetHeight(void) const;
+	bool IsEmpty(void) const;
+
+};
+
+
+#endif
\ No newline at end of file
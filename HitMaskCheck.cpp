@@ -0,0 +1,150 @@
+/**
+\file		HitMaskCheck.cpp
+\author		Tom Bisch
+\date		Jun 11, 2016
+\brief		Checks the word-at-a-time hit tests of HitMask against testing every pixel on its own.
+\details	Random surfaces of random sizes and densities are packed into hit masks, then tested against
+			each other at random offsets with HitMask::Overlaps and at random points with HitMask::Contains,
+			including offsets and points outside of the masks. Every answer is compared with the answer
+			found by reading the alpha of each pixel of the surfaces.
+
+			Usage: HitMaskCheck [cases]
+*/
+
+
+// include files
+#include "HitMask.h"
+#include <cstdio>
+#include <cstdlib>
+using namespace std;
+
+
+// constants
+const int DEFAULT_CASES = 3000;			// the number of pairs of surfaces tested when none are passed
+const int TESTS_PER_CASE = 20;			// the offsets and points tested for each pair of surfaces
+
+
+// prototypes
+void FillRandom(PixelSurface* surface, unsigned int* random, int density);
+bool IsSolid(const PixelSurface* surface, int x, int y);
+bool OverlapsByPixel(const PixelSurface* a, const PixelSurface* b, int x, int y);
+unsigned int NextRandom(unsigned int* random);
+
+
+/**
+\brief		Tests random pairs of masks and prints the number of answers that differ.
+\param[in]	argc The number of command line arguments.
+\param[in]	argv The command line arguments: the number of pairs of surfaces to test.
+\return		0 if every answer matched, 1 if any differed.
+*/
+int main(int argc, char** argv)
+{
+	int cases = argc > 1 ? atoi(argv[1]) : DEFAULT_CASES;
+	unsigned int random = 1;
+	int failures = 0;
+	for (int i = 0; i < cases; i++)
+	{
+		// widths up to 200 pixels cover masks of one to four words per row
+		PixelSurface a(NextRandom(&random) % 200 + 1, NextRandom(&random) % 50 + 1);
+		PixelSurface b(NextRandom(&random) % 200 + 1, NextRandom(&random) % 50 + 1);
+		int density = NextRandom(&random) % 200 + 1;
+		FillRandom(&a, &random, density);
+		FillRandom(&b, &random, density);
+		HitMask maskA;
+		HitMask maskB;
+		maskA.Build(&a);
+		maskB.Build(&b);
+
+		for (int j = 0; j < TESTS_PER_CASE; j++)
+		{
+			int x = (int)(NextRandom(&random) % 500) - 250;
+			int y = (int)(NextRandom(&random) % 120) - 60;
+			if (maskA.Overlaps(&maskB, x, y) != OverlapsByPixel(&a, &b, x, y))
+			{
+				failures++;
+				printf("Overlaps differs: %dx%d and %dx%d at %d, %d\n", a.GetWidth(), a.GetHeight(), b.GetWidth(), b.GetHeight(), x, y);
+			}
+			int px = (int)(NextRandom(&random) % 240) - 20;
+			int py = (int)(NextRandom(&random) % 70) - 10;
+			if (maskA.Contains(px, py) != IsSolid(&a, px, py))
+			{
+				failures++;
+				printf("Contains differs: %dx%d at %d, %d\n", a.GetWidth(), a.GetHeight(), px, py);
+			}
+		}
+	}
+	printf("%d cases, %d differences\n", cases, failures);
+	return failures == 0 ? 0 : 1;
+}
+
+
+/**
+\brief		Fills a surface with transparent pixels and a scattering of pixels of random alpha.
+\param[in,out]	surface The surface to fill.
+\param[in,out]	random The state of the random number generator.
+\param[in]	density One pixel in this many, on average, is not transparent.
+*/
+void FillRandom(PixelSurface* surface, unsigned int* random, int density)
+{
+	for (int y = 0; y < surface->GetHeight(); y++)
+	{
+		unsigned int* row = surface->GetRow(y);
+		for (int x = 0; x < surface->GetWidth(); x++)
+		{
+			row[x] = NextRandom(random) % density == 0 ? (NextRandom(random) % 256) << 24 : 0;
+		}
+	}
+}
+
+
+/**
+\brief		Checks if a pixel of a surface is solid enough to be hit, reading its alpha.
+\param[in]	surface The surface.
+\param[in]	x The X coordinate of the pixel, which may be outside of the surface.
+\param[in]	y The Y coordinate of the pixel, which may be outside of the surface.
+\return		True if the pixel is inside the surface and solid.
+*/
+bool IsSolid(const PixelSurface* surface, int x, int y)
+{
+	if (x < 0 || y < 0 || x >= surface->GetWidth() || y >= surface->GetHeight())
+	{
+		return false;
+	}
+	return (surface->GetRow(y)[x] >> 24) >= HitMask::ALPHA_THRESHOLD;
+}
+
+
+/**
+\brief		Checks if two surfaces have a solid pixel in common by testing every pixel of the second.
+\param[in]	a The first surface.
+\param[in]	b The second surface.
+\param[in]	x The X coordinate of the second surface's left edge, relative to the first surface.
+\param[in]	y The Y coordinate of the second surface's top edge, relative to the first surface.
+\return		True if a solid pixel of the second surface lies on a solid pixel of the first.
+*/
+bool OverlapsByPixel(const PixelSurface* a, const PixelSurface* b, int x, int y)
+{
+	for (int row = 0; row < b->GetHeight(); row++)
+	{
+		for (int column = 0; column < b->GetWidth(); column++)
+		{
+			if (IsSolid(b, column, row) == true && IsSolid(a, column + x, row + y) == true)
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+
+/**
+\brief		Returns the next number of a linear congruential generator, the same on every platform.
+\param[in,out]	random The state of the generator.
+\return		A number from 0 to 32767.
+*/
+unsigned int NextRandom(unsigned int* random)
+{
+	*random = *random * 1103515245 + 12345;
+	return (*random >> 16) & 0x7FFF;
+}
\ No newline at end of file
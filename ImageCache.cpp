@@ -0,0 +1,295 @@
+#include "ImageCache.h"
+#include "ChromaKey.h"
+
+
+// class members
+std::map<ImageRequest, std::weak_ptr<const PixelSurface> > ImageCache::surfaces;
+std::map<wstring, std::weak_ptr<const MipChain> > ImageCache::chains;
+std::mutex ImageCache::lock;
+
+
+/**
+\brief		Returns the decoded pixels of the passed image file.
+\details	The file is only decoded if no BitmapImage is using it already. A file that cannot be 
+			decoded gives an empty surface.
+\param[in]	path The path to the image file.
+\return		A shared pointer to the decoded surface.
+*/
+std::shared_ptr<const PixelSurface> ImageCache::Load(wstring path)
+{
+	ImageRequest request = { path, 0, 0, false, { 0, 0 }, Resampler::FILTER_NEAREST, false };
+	std::shared_ptr<const PixelSurface> surface = Find(&request);
+	if (surface == nullptr)
+	{
+		PixelSurface* decoded = new PixelSurface();
+		decoded->Load(path);
+		surface = Store(&request, std::shared_ptr<const PixelSurface>(decoded));
+	}
+	return surface;
+}
+
+
+/**
+\brief		Returns the pixels of the passed image file scaled to the passed size.
+\details	The surface is scaled from the decoded image and has the color key baked into its alpha 
+			channel, unless one with the same size and key is already in use. If the size matches the 
+			decoded image and there is no key, the decoded surface itself is returned.
+\param[in]	path The path to the image file.
+\param[in]	width The width to scale the image to.
+\param[in]	height The height to scale the image to.
+\param[in]	key The range of colors to make fully transparent, or NULL to keep every pixel.
+\param[in]	filter The filter to scale the image with.
+\return		A shared pointer to the scaled surface.
+*/
+std::shared_ptr<const PixelSurface> ImageCache::Get(wstring path, int width, int height, const ColorKey* key, Resampler::Filter filter)
+{
+	ImageRequest request = { path, width, height, key != NULL, { 0, 0 }, filter, false };
+	if (key != NULL)
+	{
+		request.colorKey = *key;
+	}
+	return Get(&request);
+}
+
+
+/**
+\brief		Returns the version of an image file described by the passed request.
+\details	The surface is scaled from the decoded image and has the color key baked into its alpha 
+			channel, unless one with the same size and key is already in use. If the size matches the 
+			decoded image and there is no key, the decoded surface itself is returned. A mipmapped
+			request is scaled from the nearest larger mipmap instead, and gets the mipmap itself if 
+			the size matches it and there is no key.
+\param[in]	request The path, size, color key, filter and mipmapping of the image.
+\return		A shared pointer to the scaled surface.
+*/
+std::shared_ptr<const PixelSurface> ImageCache::Get(const ImageRequest* request)
+{
+	std::shared_ptr<const PixelSurface> original = Load(request->path);
+	if (original->IsEmpty() == true || (request->isKeyed == false && 
+		request->width == original->GetWidth() && request->height == original->GetHeight()))
+	{
+		return original;
+	}
+
+	// the chain is held until the surface is scaled, so the mipmap cannot be freed meanwhile
+	std::shared_ptr<const MipChain> chain;
+	if (request->isMipmapped == true)
+	{
+		chain = Mipmaps(request->path);
+		original = Level(chain.get(), request->width, request->height);
+		if (request->isKeyed == false && 
+			request->width == original->GetWidth() && request->height == original->GetHeight())
+		{
+			return original;
+		}
+	}
+
+	// a surface that is not scaled is the same whatever the filter
+	ImageRequest unfiltered;
+	if (request->width == original->GetWidth() && request->height == original->GetHeight())
+	{
+		unfiltered = *request;
+		unfiltered.filter = Resampler::FILTER_NEAREST;
+		request = &unfiltered;
+	}
+
+	std::shared_ptr<const PixelSurface> surface = Find(request);
+	if (surface == nullptr)
+	{
+		PixelSurface* scaled = new PixelSurface();
+		Resampler::Scale(scaled, original.get(), request->width, request->height, request->filter);
+		if (request->isKeyed == true)
+		{
+			ChromaKey::Apply(scaled, &request->colorKey);
+		}
+		surface = Store(request, std::shared_ptr<const PixelSurface>(scaled));
+	}
+	return surface;
+}
+
+
+/**
+\brief		Returns the mipmap chain of the passed image file.
+\details	The chain is only built if no BitmapImage is using it already. Each mipmap is box filtered 
+			from the one before it to half its width and height, rounded down, until a mipmap is a 
+			single pixel. The chain takes a third more memory than the decoded image on its own.
+\param[in]	path The path to the image file.
+\return		A shared pointer to the chain, starting with the decoded image.
+*/
+std::shared_ptr<const MipChain> ImageCache::Mipmaps(wstring path)
+{
+	std::shared_ptr<const MipChain> chain;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		chain = chains[path].lock();
+	}
+	if (chain != nullptr)
+	{
+		return chain;
+	}
+
+	MipChain* built = new MipChain();
+	built->push_back(Load(path));
+	const PixelSurface* level = built->back().get();
+	while (level->IsEmpty() == false && (level->GetWidth() > 1 || level->GetHeight() > 1))
+	{
+		int halfWidth = level->GetWidth() > 1 ? level->GetWidth() / 2 : 1;
+		int halfHeight = level->GetHeight() > 1 ? level->GetHeight() / 2 : 1;
+		PixelSurface* half = new PixelSurface();
+		Resampler::Scale(half, level, halfWidth, halfHeight, Resampler::FILTER_BOX);
+		built->push_back(std::shared_ptr<const PixelSurface>(half));
+		level = half;
+	}
+	chain.reset(built);
+
+	// keep the chain another thread stored while this one was being built
+	std::lock_guard<std::mutex> guard(lock);
+	std::shared_ptr<const MipChain> stored = chains[path].lock();
+	if (stored != nullptr)
+	{
+		return stored;
+	}
+	std::map<wstring, std::weak_ptr<const MipChain> >::iterator i = chains.begin();
+	while (i != chains.end())
+	{
+		if (i->second.expired() == true)
+		{
+			i = chains.erase(i);
+		}
+		else
+		{
+			i++;
+		}
+	}
+	chains[path] = chain;
+	return chain;
+}
+
+
+/**
+\brief		Picks the mipmap to scale a surface of the passed size from.
+\param[in]	chain The mipmap chain of the image.
+\param[in]	width The width the image is scaled to.
+\param[in]	height The height the image is scaled to.
+\return		The smallest mipmap at least as large as the passed size, or the decoded image when enlarging.
+*/
+std::shared_ptr<const PixelSurface> ImageCache::Level(const MipChain* chain, int width, int height)
+{
+	unsigned int level = 0;
+	while (level + 1 < chain->size() && 
+		(*chain)[level + 1]->GetWidth() >= width && (*chain)[level + 1]->GetHeight() >= height)
+	{
+		level++;
+	}
+	return (*chain)[level];
+}
+
+
+/**
+\brief		Counts the surfaces that are still in use by at least one BitmapImage.
+\return		The number of shared surfaces.
+*/
+int ImageCache::SurfaceCount(void)
+{
+	std::lock_guard<std::mutex> guard(lock);
+	int count = 0;
+	std::map<ImageRequest, std::weak_ptr<const PixelSurface> >::iterator i = surfaces.begin();
+	while (i != surfaces.end())
+	{
+		if (i->second.expired() == false)
+		{
+			count++;
+		}
+		i++;
+	}
+	return count;
+}
+
+
+/**
+\brief		Looks up a surface that is still in use.
+\param[in]	request The version of the image file to look up.
+\return		A shared pointer to the surface, or an empty pointer if it is not in use.
+*/
+std::shared_ptr<const PixelSurface> ImageCache::Find(const ImageRequest* request)
+{
+	std::lock_guard<std::mutex> guard(lock);
+	std::map<ImageRequest, std::weak_ptr<const PixelSurface> >::iterator i = surfaces.find(*request);
+	if (i == surfaces.end())
+	{
+		return std::shared_ptr<const PixelSurface>();
+	}
+	return i->second.lock();
+}
+
+
+/**
+\brief		Adds a surface to the cache and forgets the surfaces that are no longer in use.
+\details	If another thread stored the same version while this one was being made, the stored
+			surface is kept and returned instead, so every user shares the same pixels.
+\param[in]	request The version of the image file the surface holds.
+\param[in]	surface The surface to share.
+\return		A shared pointer to the surface that is in the cache.
+*/
+std::shared_ptr<const PixelSurface> ImageCache::Store(const ImageRequest* request, std::shared_ptr<const PixelSurface> surface)
+{
+	std::lock_guard<std::mutex> guard(lock);
+	std::shared_ptr<const PixelSurface> stored = surfaces[*request].lock();
+	if (stored != nullptr)
+	{
+		return stored;
+	}
+	std::map<ImageRequest, std::weak_ptr<const PixelSurface> >::iterator i = surfaces.begin();
+	while (i != surfaces.end())
+	{
+		if (i->second.expired() == true)
+		{
+			i = surfaces.erase(i);
+		}
+		else
+		{
+			i++;
+		}
+	}
+	surfaces[*request] = surface;
+	return surface;
+}
+
+
+/**
+\brief		Orders image requests by path, size, color key, filter and mipmapping, so they can be used in a std::map.
+\param[in]	request The request to compare with.
+\return		True if this request comes before the passed request.
+*/
+bool ImageRequest::operator<(const ImageRequest& request) const
+{
+	if (path != request.path)
+	{
+		return path < request.path;
+	}
+	if (width != request.width)
+	{
+		return width < request.width;
+	}
+	if (height != request.height)
+	{
+		return height < request.height;
+	}
+	if (isKeyed != request.isKeyed)
+	{
+		return isKeyed < request.isKeyed;
+	}
+	if (colorKey.low != request.colorKey.low)
+	{
+		return colorKey.low < request.colorKey.low;
+	}
+	if (colorKey.high != request.colorKey.high)
+	{
+		return colorKey.high < request.colorKey.high;
+	}
+	if (filter != request.filter)
+	{
+		return filter < request.filter;
+	}
+	return isMipmapped < request.isMipmapped;
+}
\ No newline at end of file
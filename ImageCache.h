@@ -0,0 +1,72 @@
+#include "PixelSurface.h"
+#include "Resampler.h"
+#include <string>
+#include <map>
+#include <vector>
+#include <memory>
+#include <mutex>
+using namespace std;
+
+
+#ifndef __IMAGE_CACHE_H__
+#define __IMAGE_CACHE_H__
+
+
+// identifies one version of an image file
+struct ImageRequest
+{
+	wstring path;						// the path to the image file
+	int width;							// the scaled width, 0 for the decoded image
+	int height;							// the scaled height, 0 for the decoded image
+	bool isKeyed;						// indicates if the color key is baked into the alpha channel
+	ColorKey colorKey;					// the range of colors made transparent if keyed
+	Resampler::Filter filter;			// the filter the image is scaled with
+	bool isMipmapped;					// indicates if the image is scaled from the nearest larger mipmap
+
+	bool operator<(const ImageRequest& request) const;
+};
+
+
+// the decoded image followed by copies of it halved in size, down to a single pixel
+typedef std::vector<std::shared_ptr<const PixelSurface> > MipChain;
+
+
+/**
+\class		ImageCache
+\author		Tom Bisch
+\date		May 10, 2016
+\brief		Shares the decoded and scaled pixels of image files between BitmapImage objects.
+\details	This is a static class holding one surface for every image file, size and color key in use.
+			Surfaces are handed out as shared pointers to const surfaces, so any number of BitmapImages 
+			can draw the same pixels while each keeps its own position and rotation. The cache only holds 
+			weak pointers, so a surface is freed as soon as the last BitmapImage using it lets go, for 
+			example when every image has been resized to a new window size. The cache can be used from
+			several threads at once; images are decoded and scaled outside of its lock.
+			An image can also be kept as a chain of mipmaps, each half the size of the one before it.
+			A mipmapped request is scaled from the smallest mipmap that is at least as large as the
+			request, which is much cheaper than scaling from the decoded image and aliases less.
+*/
+class ImageCache
+{
+
+private:
+	static std::map<ImageRequest, std::weak_ptr<const PixelSurface> > surfaces;
+	static std::map<wstring, std::weak_ptr<const MipChain> > chains;
+	static std::mutex lock;				// guards the maps of surfaces and mipmap chains
+
+	static std::shared_ptr<const PixelSurface> Find(const ImageRequest* request);
+	static std::shared_ptr<const PixelSurface> Store(const ImageRequest* request, std::shared_ptr<const PixelSurface> surface);
+	static std::shared_ptr<const PixelSurface> Level(const MipChain* chain, int width, int height);
+
+public:
+	static std::shared_ptr<const PixelSurface> Load(wstring path);
+	static std::shared_ptr<const PixelSurface> Get(wstring path, int width, int height, const ColorKey* key = NULL, 
+		Resampler::Filter filter = Resampler::FILTER_BILINEAR);
+	static std::shared_ptr<const PixelSurface> Get(const ImageRequest* request);
+	static std::shared_ptr<const MipChain> Mipmaps(wstring path);
+	static int SurfaceCount(void);
+
+};
+
+
+#endif
\ No newline at end of file
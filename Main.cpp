@@ -5,7 +5,8 @@
 \brief		This file contains the main window and UI components for the Unhappy Flying Reptiles game.
 \details	Creates a window using win32 and then loads gdi+ and image resources before animating an
 			unhappy flying reptile across the screen. In loading the resources, BitmapImage and CompositeImage 
-			objects and inherited versions are used to store image resources to be drawn onto the window. 
+			objects are used to store image resources to be drawn onto the window, while a World object owns 
+			and steps the reptile, boxes and scoreboard independently of the window. 
 			The player can click on the window in an attempt to shoot the flying reptile and if successful, 
 			will see the reptile fall rotating to the ground. The player earns points based on how quickly the 
 			reptile is shot down. Extra points are awarded if the reptile happens to knock one of the top 3 boxes
@@ -18,13 +19,26 @@
 #pragma comment(lib, "winmm.lib")
 #include "CompositeImage.h"
 #include "BitmapImage.h"
-#include "Reptile.h"
-#include "Box.h"
-#include "Scoreboard.h"
+#include "World.h"
+#include "PixelSurface.h"
+#include "GdiSurface.h"
+#include "RenderTarget.h"
+#include "DirtyRegion.h"
+#include "ImageCache.h"
+#include "ThreadPool.h"
+#include "Rescaler.h"
+#include "SpriteAtlas.h"
+#include "TileCompositor.h"
+#include "RenderQueue.h"
 #include <windows.h>
 #include <gdiplus.h>
 #include <string>
 #include <ctime>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cstdlib>
 using namespace Gdiplus;
 using namespace std;
 
@@ -32,9 +46,15 @@ using namespace std;
 // prototypes
 void LoadResources(HWND hWnd);
 void UnloadResources(void);
-void Draw(HWND hWnd);
-void Update(void);
+void Draw(void);
+void QueueScene(bool isFlashing);
+void MarkDirty(bool isFlashing);
+void MarkSprite(PixelRect* drawn, PixelRect bounds, bool changed);
+void DrawScoreboard(Gdiplus::Graphics* g, Scoreboard* scoreboard, int windowWidth, int windowHeight);
 void WindowResize(int width, int height);
+void ResizeImages(int width, int height, std::vector<ImageRequest>* requests);
+void SwapResizedImages(void);
+void BuildAtlas(void);
 LRESULT CALLBACK WinProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
 
 
@@ -42,21 +62,56 @@ LRESULT CALLBACK WinProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
 ULONG_PTR gdiplusToken;
 int WINDOW_WIDTH = 640;
 int WINDOW_HEIGHT = 400;
+RenderTarget* renderTarget;
+ThreadPool* threadPool;				// worker threads for rescaling images
+Rescaler* rescaler;					// rescales the images after the window is resized
+SpriteAtlas* atlas;					// the small sprites packed together after every resize
+ThreadPool* drawPool;				// worker threads for drawing the tiles of each frame
+TileCompositor* compositor;			// draws the dirty parts of each frame as tiles in parallel
+RenderQueue* renderQueue;			// the commands drawing the current frame
+const int SCOREBOARD_HEIGHT = 40;
+
+
+// the layers the scene is drawn in, from back to front
+enum Layer
+{
+	LAYER_BACKGROUND,
+	LAYER_BOXES,
+	LAYER_SWARM,
+	LAYER_REPTILE,
+	LAYER_CURSOR,
+	LAYER_FLASH
+};
+
+
+// dirty rectangle tracking
+DirtyRegion* dirtyRegion;			// the parts of the window to redraw in the next frame
+std::vector<PixelRect> drawnBoxes;	// the bounds of each box when it was last drawn
+PixelRect drawnReptile;				// the bounds of the reptile when it was last drawn
+int drawnReptileFrame;				// the image/frame of the reptile when it was last drawn
+int drawnReptileRotation;			// the rotation of the reptile when it was last drawn
+PixelRect drawnSlingshot;			// the bounds of the slingshot cursor when it was last drawn
+PixelRect drawnFlash;				// the bounds of the screen flash when it was last drawn
+int drawnScores[3];					// the total score, round score and round when they were last drawn
+
 
+// game state
+World* world;
+int swarmSize = 0;					// the number of reptiles in the swarm, set with /swarm N on the command line
+string structurePath;				// the file describing the box structures, set with /structure PATH on the command line
 
-// game objects
+
+// image objects
 CompositeImage* background;
 CompositeImage* slingshot;
-Reptile* reptile;
-Box* boxes[6];
+CompositeImage* reptileImage;
+int reptileFrames[Reptile::FRAME_COUNT];	// the handle in reptileImage of each reptile frame
+BitmapImage* boxImage;
 BitmapImage* flash;
 
 
 int WINAPI WinMain(HINSTANCE hInst, HINSTANCE hPrevInst, LPSTR lpCmdLine, int nShowCmd) 
 {
-	// seed random number generator
-	srand((unsigned)time(0));
-
 	// declare window objects
 	WNDCLASSEX window;
 	HWND windowHandle;
@@ -100,6 +155,20 @@ int WINAPI WinMain(HINSTANCE hInst, HINSTANCE hPrevInst, LPSTR lpCmdLine, int nS
 		MessageBox(NULL, L"Window Creation Failed", L"Window Creation Failed", MB_ICONERROR);
 	}
 
+	// fly a swarm of extra reptiles if asked to on the command line
+	const char* swarmOption = strstr(lpCmdLine, "/swarm");
+	if (swarmOption != NULL)
+	{
+		swarmSize = atoi(swarmOption + strlen("/swarm"));
+	}
+	// stand the boxes in other structures if asked to on the command line
+	const char* structureOption = strstr(lpCmdLine, "/structure");
+	if (structureOption != NULL)
+	{
+		std::istringstream option(structureOption + strlen("/structure"));
+		option >> structurePath;
+	}
+
 	// load resources before showing window
 	LoadResources(windowHandle);
 
@@ -131,6 +200,8 @@ int WINAPI WinMain(HINSTANCE hInst, HINSTANCE hPrevInst, LPSTR lpCmdLine, int nS
 */
 LRESULT CALLBACK WinProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 {
+	int shot;
+
 	switch (message) 
 	{
 		// hide cursor for client area of window
@@ -147,10 +218,17 @@ LRESULT CALLBACK WinProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 			WindowResize(LOWORD(lParam), HIWORD(lParam));
 			break;
 
+		// window uncovered, repaint it from the last frame
+		case WM_PAINT:
+			renderTarget->Paint();
+			return 0;
+			break;
+
 		// timer event handler (game loop)
 		case WM_TIMER:
-			Update();
-			Draw(hWnd);		
+			world->Step();
+			SwapResizedImages();
+			Draw();		
 			break;
 
 		// mouse move
@@ -160,22 +238,14 @@ LRESULT CALLBACK WinProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 
 		// click event
 		case WM_LBUTTONDOWN:
-			// check for collision with reptile
-			if (reptile->CheckCollision(LOWORD(lParam), HIWORD(lParam)) == true)
-			{			
-				if (reptile->GetState() == Reptile::STATE_FLYING)
-				{
-					// set is hit for screen flash
-					reptile->SetIsHit(true);
-					// end the round to stop round score from decreasing
-					Scoreboard::EndRound();
-					// play reptile shot sound
-					PlaySound(L"Sounds\\reptileshot.wav", NULL, SND_ASYNC | SND_FILENAME);
-					// set the new state for reptile
-					reptile->SetState(Reptile::STATE_FALLING);
-				}					
+			// shoot at the reptile
+			shot = world->Shoot(LOWORD(lParam), HIWORD(lParam));
+			if (shot == World::SHOT_HIT)
+			{
+				// play reptile shot sound
+				PlaySound(L"Sounds\\reptileshot.wav", NULL, SND_ASYNC | SND_FILENAME);
 			}
-			if (reptile->GetState() == Reptile::STATE_FLYING)
+			else if (shot == World::SHOT_MISS)
 			{
 				// reptile missed so play gunshot sound
 				PlaySound(L"Sounds\\gunshot.wav", NULL, SND_ASYNC | SND_FILENAME);
@@ -194,7 +264,10 @@ LRESULT CALLBACK WinProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 
 
 /**
-\brief		Resizes all the bitmap images to fit the new window size.
+\brief		Resizes the back buffer and game state to the new window size and requests new images.
+\details	The images are scaled for the new size on worker threads, and keep drawing at their 
+			previous size until the scaled surfaces are ready. A drag-resize sends many WM_SIZE 
+			messages, but only the latest size is scaled once the running batch finishes.
 \param[in]	width The new width of the window.
 \param[in]	height The new height of the window.
 */
@@ -203,166 +276,284 @@ void WindowResize(int width, int height)
 	// set new widow dimensions
 	WINDOW_WIDTH = width;
 	WINDOW_HEIGHT = height;
+	// back buffer, all of which must be redrawn
+	renderTarget->Resize(WINDOW_WIDTH, WINDOW_HEIGHT);
+	dirtyRegion->SetBounds(WINDOW_WIDTH, WINDOW_HEIGHT);
+	// game state
+	world->Resize(WINDOW_WIDTH, WINDOW_HEIGHT);
+	// images, unless the window is minimized
+	if (WINDOW_WIDTH > 0 && WINDOW_HEIGHT > 0)
+	{
+		std::vector<ImageRequest> requests;
+		ResizeImages(WINDOW_WIDTH, WINDOW_HEIGHT, &requests);
+		rescaler->Request(WINDOW_WIDTH, WINDOW_HEIGHT, &requests);
+	}
+}
+
+
+/**
+\brief		Resizes all the bitmap images to fit the passed window size.
+\details	If a list of requests is passed, the images are left unchanged and the surfaces they 
+			need are added to the list instead, so the sizes of the images are only set here.
+\param[in]	width The width of the window.
+\param[in]	height The height of the window.
+\param[out]	requests The list to add the needed surfaces to, or NULL to resize the images.
+*/
+void ResizeImages(int width, int height, std::vector<ImageRequest>* requests)
+{
+	if (requests != NULL)
+	{
+		background->RequestResize(width, height, false, requests);
+		slingshot->RequestResize(1.0, 0.7, true, requests);
+		reptileImage->RequestResize((int)(width / 9.6), height / 6, false, requests);
+		return;
+	}
 	// background
-	background->Resize(WINDOW_WIDTH, WINDOW_HEIGHT);
+	background->Resize(width, height);
 	// slingshot
 	slingshot->Resize(1.0, 0.7, true);
 	// reptile
-	reptile->Resize((int)(WINDOW_WIDTH / 9.6), WINDOW_HEIGHT / 6);
+	reptileImage->Resize((int)(width / 9.6), height / 6);
+	// pack the sprites drawn every frame next to each other in memory
+	BuildAtlas();
 }
 
 
 /**
-\brief		Updates the game objects for the next frame.
-\details	Updates the position of the reptile and all boxes. Updates the scoreboard to
-			so that the round score can be decremented. Checks the reptile for collisions
-			against boxes. Checks boxes for collisions against other boxes. Adds bonus
-			points to the total score if one of the 3 top boxes falls down.
+\brief		Packs the surfaces of the small sprites into the sprite atlas.
+\details	In debug builds the layout of the atlas is written to atlas.txt.
 */
-void Update(void)
+void BuildAtlas(void)
 {
-	// update the reptile position
-	if (reptile->Update(WINDOW_WIDTH, WINDOW_HEIGHT) == true)
-	{
-		// if reptile update method returns true, 
-		// the next round is starting so the boxes should be reset
+	std::vector<BitmapImage*> sprites;
+	slingshot->GetBitmapImages(&sprites);
+	reptileImage->GetBitmapImages(&sprites);
+	sprites.push_back(boxImage);
+	atlas->Build(&sprites);
+#ifdef _DEBUG
+	std::wofstream layout("atlas.txt");
+	atlas->DumpLayout(layout);
+#endif
+}
 
-		// reset boxes
-		for (int i = 0; i < 6; i++)
-		{
-			boxes[i]->Reset();
-		}
-	}
 
-	// check boxes for collisions if reptile is falling or grounded
-	if (reptile->GetState() != reptile->STATE_FLYING)
+/**
+\brief		Swaps in the images scaled on worker threads, if a batch has finished since the last frame.
+*/
+void SwapResizedImages(void)
+{
+	int width;
+	int height;
+	std::vector<std::shared_ptr<const PixelSurface> > surfaces;
+	if (rescaler->TakeReady(&width, &height, &surfaces) == true)
 	{
-		// check all boxes against reptile
-		bool collision = false;
-		for (int i = 0; i < 6; i++)
-		{
-			if (boxes[i]->CheckCollision(WINDOW_WIDTH, WINDOW_HEIGHT, reptile) == true)
-			{
-				collision = true;
-			}
-		}
-		// if no boxes are colliding with reptile, set reptile vertical velocity
-		if (collision == false)
-		{
-			reptile->SetYVel(5);
-		}
+		// the surfaces are kept alive until the images have taken them from the cache
+		ResizeImages(width, height, NULL);
+		dirtyRegion->AddAll();
+	}
+}
 
-		// after one of the top 3 boxes has fallen, add 1 bonus point to total score each frame until the round restarts
 
-		// check top box against boxes below
-		if (boxes[0]->CheckCollision(WINDOW_WIDTH, WINDOW_HEIGHT, boxes[1]) == false &&
-			boxes[0]->CheckCollision(WINDOW_WIDTH, WINDOW_HEIGHT, boxes[2]) == false)
-		{
-			// top box knocked onto ground
-			Scoreboard::AddPoints(1);
-			boxes[0]->SetYVel(5);
-		}
-		// check midleft against boxes below and to right
-		if (boxes[1]->CheckCollision(WINDOW_WIDTH, WINDOW_HEIGHT, boxes[2], true) == false &&
-			boxes[1]->CheckCollision(WINDOW_WIDTH, WINDOW_HEIGHT, boxes[3]) == false &&
-			boxes[1]->CheckCollision(WINDOW_WIDTH, WINDOW_HEIGHT, boxes[4]) == false)
-		{
-			// midleft box knocked onto ground
-			Scoreboard::AddPoints(1);
-			boxes[1]->SetYVel(5);
-		}
-		// check midright against boxes below and to left
-		if (boxes[2]->CheckCollision(WINDOW_WIDTH, WINDOW_HEIGHT, boxes[1], true) == false &&
-			boxes[2]->CheckCollision(WINDOW_WIDTH, WINDOW_HEIGHT, boxes[4]) == false &&
-			boxes[2]->CheckCollision(WINDOW_WIDTH, WINDOW_HEIGHT, boxes[5]) == false)
-		{
-			// midright box knocked onto ground
-			Scoreboard::AddPoints(1);
-			boxes[2]->SetYVel(5);
-		}
-		// check botleft against botcenter
-		boxes[3]->CheckCollision(WINDOW_WIDTH, WINDOW_HEIGHT, boxes[4], true);
-		// check botcenter against botleft and botright
-		boxes[4]->CheckCollision(WINDOW_WIDTH, WINDOW_HEIGHT, boxes[3], true);
-		boxes[4]->CheckCollision(WINDOW_WIDTH, WINDOW_HEIGHT, boxes[5], true);
-		// check botright against botcenter
-		boxes[5]->CheckCollision(WINDOW_WIDTH, WINDOW_HEIGHT, boxes[4], true);
-
-		// update position of each box
-		for (int i = 0; i < 6; i++)
-		{
-			boxes[i]->Update(WINDOW_WIDTH, WINDOW_HEIGHT);
-		}
+/**
+\brief		Adds the old and new bounds of a sprite to the dirty region if the sprite changed.
+\param[in,out]	drawn The bounds of the sprite when it was last drawn, updated to the new bounds.
+\param[in]	bounds The bounds of the sprite in this frame.
+\param[in]	changed Indicates if the sprite looks different even if its bounds are the same.
+*/
+void MarkSprite(PixelRect* drawn, PixelRect bounds, bool changed)
+{
+	if (changed == true || bounds.x != drawn->x || bounds.y != drawn->y ||
+		bounds.width != drawn->width || bounds.height != drawn->height)
+	{
+		dirtyRegion->Add(*drawn);
+		dirtyRegion->Add(bounds);
+		*drawn = bounds;
 	}
+}
+
 
-	// update scoreboard
-	if (Scoreboard::Update(WINDOW_WIDTH, WINDOW_HEIGHT) == true)
+/**
+\brief		Finds the parts of the window that changed since the last frame.
+\details	Compares the bounds and appearance of every sprite with how it was last drawn, 
+			and adds the union of the old and new bounds of every sprite that changed to the 
+			dirty region. The scoreboard strip is added whenever one of the scores changes, and the
+			whole window while a swarm is flying.
+\param[in]	isFlashing Indicates if the screen flash is drawn in this frame.
+*/
+void MarkDirty(bool isFlashing)
+{
+	Reptile* reptile = world->GetReptile();
+	PixelRect bounds;
+
+	// boxes
+	drawnBoxes.resize(world->BoxCount());
+	for (int i = 0; i < world->BoxCount(); i++)
+	{
+		Box* box = world->GetBox(i);
+		bounds.x = box->GetXPos();
+		bounds.y = box->GetYPos();
+		bounds.width = boxImage->GetWidth();
+		bounds.height = boxImage->GetHeight();
+		MarkSprite(&drawnBoxes[i], bounds, false);
+	}
+	// reptile, whose frame and rotation change while its bounds may stay the same
+	reptileImage->MoveTo(reptile->GetXPos(), reptile->GetYPos());
+	reptileImage->Rotate(reptile->GetRotation());
+	bounds = reptileImage->GetBitmapImage(reptileFrames[reptile->GetFrameToDraw()])->GetBounds();
+	MarkSprite(&drawnReptile, bounds, reptile->GetFrameToDraw() != drawnReptileFrame || 
+		reptile->GetRotation() != drawnReptileRotation);
+	drawnReptileFrame = reptile->GetFrameToDraw();
+	drawnReptileRotation = reptile->GetRotation();
+	// slingshot cursor
+	bounds.x = slingshot->GetXPos();
+	bounds.y = slingshot->GetYPos();
+	bounds.width = slingshot->GetWidth();
+	bounds.height = slingshot->GetHeight();
+	MarkSprite(&drawnSlingshot, bounds, false);
+	// screen flash, which has empty bounds when it is not drawn
+	bounds.x = 0;
+	bounds.y = 0;
+	bounds.width = isFlashing ? flash->GetWidth() : 0;
+	bounds.height = isFlashing ? flash->GetHeight() : 0;
+	MarkSprite(&drawnFlash, bounds, false);
+	// scoreboard
+	Scoreboard* scoreboard = world->GetScoreboard();
+	if (scoreboard->GetTotalScore() != drawnScores[0] || scoreboard->GetRoundScore() != drawnScores[1] || 
+		scoreboard->GetRound() != drawnScores[2])
+	{
+		drawnScores[0] = scoreboard->GetTotalScore();
+		drawnScores[1] = scoreboard->GetRoundScore();
+		drawnScores[2] = scoreboard->GetRound();
+		PixelRect strip = { 0, 0, WINDOW_WIDTH, SCOREBOARD_HEIGHT };
+		dirtyRegion->Add(strip);
+	}
+	// the swarm moves all over the window every frame, so redraw all of it while there is one
+	if (world->GetSwarm()->Count() > 0)
 	{
-		// if the scoreboard update method returns true, 
-		// the round score for that round hit zero and the next round needs to start by resetting the reptile
-		reptile->Reset(WINDOW_WIDTH, WINDOW_HEIGHT);
+		dirtyRegion->AddAll();
 	}
 }
 
 
 /**
-\brief		Draws all the game objects to the window.
-\param[in]	hWnd The handle to the window.
+\brief		Submits the commands drawing all the game objects to the render queue and sorts them.
+\details	Each command captures where its sprite is now, and sorting prepares the sprites, so the 
+			commands can be drawn onto different tiles from several threads.
+\param[in]	isFlashing Indicates if the screen flash is drawn in this frame.
 */
-void Draw(HWND hWnd)
+void QueueScene(bool isFlashing)
 {
-	RECT rcClient;
-	GetClientRect(hWnd, &rcClient);
-	int left = rcClient.left;
-	int top = rcClient.top;
-	int width = rcClient.right - rcClient.left;
-	int height = rcClient.bottom - rcClient.top;
-
-	HDC hdc = GetDC(hWnd);
-	HDC hdcMem = CreateCompatibleDC(hdc);
-	const int nMemDC = SaveDC(hdcMem);
-
-	HBITMAP hBitmap = CreateCompatibleBitmap(hdc, width, height);
-	SelectObject(hdcMem, hBitmap);
-
-	// Graphics object used for drawing to window
-	Gdiplus::Graphics graphics(hdcMem);
-	// ImageAttributes object used to draw primarily green pixels as transparent
-	Gdiplus::ImageAttributes imgAttr;
-	imgAttr.SetColorKey(Gdiplus::Color(0, 155, 0), Gdiplus::Color(100, 255, 100));
-
-	// draw game objects
-		
-	// background
-	background->Draw(&graphics, &imgAttr);
-	// boxes
-	for (int i = 0; i < 6; i++)
+	Reptile* reptile = world->GetReptile();
+
+	renderQueue->Clear();
+	// background, copied from its opaque cache so the back buffer does not need clearing first
+	renderQueue->Submit(background, LAYER_BACKGROUND);
+	// boxes, all drawn by the one box image
+	for (int i = 0; i < world->BoxCount(); i++)
 	{
-		boxes[i]->Draw(&graphics);
+		boxImage->MoveTo(world->GetBox(i)->GetXPos(), world->GetBox(i)->GetYPos());
+		renderQueue->Submit(boxImage, LAYER_BOXES);
 	}
-	// reptile
-	reptile->DrawSingle(&graphics, reptile->GetNameOfImageToDraw());
+	// swarm, each reptile drawn by the bitmap of its frame, shared by the whole swarm
+	ReptileFlock* swarm = world->GetSwarm();
+	for (int i = 0; i < swarm->Count(); i++)
+	{
+		renderQueue->Submit(reptileImage->GetBitmapImage(reptileFrames[swarm->GetFrameToDraw(i)]), swarm->GetXPos(i), 
+			swarm->GetYPos(i), swarm->GetRotation(i), LAYER_SWARM);
+	}
+	// reptile, already moved and rotated by MarkDirty
+	renderQueue->Submit(reptileImage->GetBitmapImage(reptileFrames[reptile->GetFrameToDraw()]), LAYER_REPTILE);
 	// slingshot cursor
-	slingshot->Draw(&graphics);
+	renderQueue->Submit(slingshot, LAYER_CURSOR);
 	// screen flash
-	if (reptile->GetIsHit() == true)
+	if (isFlashing == true)
 	{
-		reptile->SetIsHit(false);
-		flash->Draw(&graphics);
+		renderQueue->Submit(flash, LAYER_FLASH);
 	}
-	// scoreboard
-	Scoreboard::Draw(&graphics, WINDOW_WIDTH, WINDOW_HEIGHT);
-
-	RECT rcClip;
-	GetClipBox(hdc, &rcClip);
-	left = rcClip.left;
-	top = rcClip.top;
-	width = rcClip.right - rcClip.left;
-	height = rcClip.bottom - rcClip.top;
-	BitBlt(hdc, left, top, width, height, hdcMem, left, top, SRCCOPY);
-
-	RestoreDC(hdcMem, nMemDC);
-	DeleteObject(hBitmap);
+	renderQueue->Sort();
+}
+
+
+/**
+\brief		Draws the parts of the game that changed since the last frame to the window.
+\details	Only the rectangles in the dirty region are redrawn onto the back buffer, as tiles drawn 
+			in parallel by the compositor, and presented to the window, the rest of the window still 
+			shows the last frame.
+*/
+void Draw(void)
+{
+	// the screen flash is drawn for a single frame after the reptile is hit
+	Reptile* reptile = world->GetReptile();
+	bool isFlashing = reptile->GetIsHit();
+	reptile->SetIsHit(false);
+
+	// the scoreboard is drawn over the scene, so redraw all of it if any of it is covered
+	MarkDirty(isFlashing);
+	PixelRect strip = { 0, 0, WINDOW_WIDTH, SCOREBOARD_HEIGHT };
+	bool isScoreboardDirty = dirtyRegion->Intersects(&strip);
+	if (isScoreboardDirty == true)
+	{
+		dirtyRegion->Add(strip);
+	}
+	if (dirtyRegion->RectCount() == 0)
+	{
+		return;
+	}
+
+	// redraw the changed rectangles onto the back buffer
+	PixelSurface* backBuffer = renderTarget->BeginFrame();
+	if (backBuffer->IsEmpty() == false)
+	{
+		QueueScene(isFlashing);
+		compositor->Clear();
+		renderQueue->Dispatch(compositor);
+		compositor->Compose(backBuffer, dirtyRegion);
+		// scoreboard, drawn by GDI+ on this thread once the tiles are finished
+		if (isScoreboardDirty == true)
+		{
+			DrawScoreboard(renderTarget->GetGraphics(), world->GetScoreboard(), WINDOW_WIDTH, WINDOW_HEIGHT);
+		}
+
+		// copy the changed rectangles to the window
+		for (int i = 0; i < dirtyRegion->RectCount(); i++)
+		{
+			renderTarget->Present(dirtyRegion->GetRect(i));
+		}
+		dirtyRegion->Clear();
+	}
+	renderTarget->EndFrame();
+}
+
+
+/**
+\brief		Draws the scoreboard stats to the window using the passed Gdiplus::Graphics pointer.
+\param[in]	g The pointer to the graphics object used to draw to the window.
+\param[in]	scoreboard The pointer to the scoreboard whose stats are drawn.
+\param[in]	windowWidth The width of the window to draw to.
+\param[in]	windowHeight The height of the window to draw to.
+*/
+void DrawScoreboard(Gdiplus::Graphics* g, Scoreboard* scoreboard, int windowWidth, int windowHeight)
+{
+	Gdiplus::Font font(L"Vrinda", 12); // font
+	Gdiplus::SolidBrush brush(Gdiplus::Color::Black); // brush (color)
+	
+	// total score
+	wstring tScoreString = L"total score : " + to_wstring(scoreboard->GetTotalScore());
+	const WCHAR* tScoreWCHAR = tScoreString.c_str();
+	Gdiplus::PointF tScorePoint(0, 0);
+	g->DrawString(tScoreWCHAR, tScoreString.length(), &font, tScorePoint, &brush);
+
+	// round score
+	wstring rScoreString = L"round score : " + to_wstring(scoreboard->GetRoundScore());
+	const WCHAR* rScoreWCHAR = rScoreString.c_str();
+	Gdiplus::PointF rScorePoint(0, 15);
+	g->DrawString(rScoreWCHAR, rScoreString.length(), &font, rScorePoint, &brush);
+
+	// round number
+	wstring roundNumberString = L"round : " + to_wstring(scoreboard->GetRound());
+	const WCHAR* roundNumberWCHAR = roundNumberString.c_str();
+	Gdiplus::PointF roundPoint(Gdiplus::REAL(windowWidth / 2), 0);
+	g->DrawString(roundNumberWCHAR, roundNumberString.length(), &font, roundPoint, &brush);
 }
 
 
@@ -376,41 +567,99 @@ void LoadResources(HWND hWnd)
 	GdiplusStartupInput gdiplusStartupInput;
 	GdiplusStartup(&gdiplusToken, &gdiplusStartupInput, NULL);
 
-	// send WM_TIMER signal to window every 30 ms
-	SetTimer(hWnd, WM_TIMER, 30, NULL);
+	// send WM_TIMER signal to window every timestep
+	SetTimer(hWnd, WM_TIMER, World::TIMESTEP, NULL);
+
+	// create back buffer that the game objects are drawn onto, kept until the window is resized
+	renderTarget = new RenderTarget(hWnd);
+	renderTarget->Resize(WINDOW_WIDTH, WINDOW_HEIGHT);
+	threadPool = new ThreadPool();
+	rescaler = new Rescaler(threadPool);
+	drawPool = new ThreadPool();
+	compositor = new TileCompositor(drawPool);
+	renderQueue = new RenderQueue();
+	// the reptiles of the swarm overlap, so they are drawn in index order for shots to hit the one on top
+	renderQueue->KeepOrder(LAYER_SWARM);
+	dirtyRegion = new DirtyRegion();
+	dirtyRegion->SetBounds(WINDOW_WIDTH, WINDOW_HEIGHT);
 
 	// create background composite image with background, midground, and foreground images
 	background = new CompositeImage();
 	background->AddImage(BitmapImage(L"Images\\background.bmp", L"back"));
 	background->AddImage(BitmapImage(L"Images\\midground.bmp", L"mid"));
 	background->AddImage(BitmapImage(L"Images\\foreground.bmp", L"fore"));
+	// bake primarily green pixels into the background as transparent after every resize
+	ColorKey greenKey = { PixelSurface::MakeArgb(255, 0, 155, 0), PixelSurface::MakeArgb(255, 100, 255, 100) };
+	background->SetColorKey(&greenKey);
+	// the background never changes between frames, so draw it from a flattened cache
+	background->SetCached(true);
+	// the background fills the window, so scale it with a cheap filter
+	background->SetFilter(Resampler::FILTER_BILINEAR);
+	// bilinear aliases when shrinking, so shrink the background from the nearest larger mipmap
+	background->SetMipmapped(true);
 
 	// create slingshot cursor
 	slingshot = new CompositeImage();
 	slingshot->AddImage(BitmapImage(L"Images\\slingshot2.png", L"slingBack"));	
 	slingshot->AddImage(BitmapImage(L"Images\\slingshot1.png", L"slingFore"));
 	slingshot->AddImage(BitmapImage(L"Images\\cross.png", L"cross"));
-
-	// create reptile
-	reptile = new Reptile();
-	reptile->AddImage(BitmapImage(L"Images\\flap0.png", L"flap0"));
-	reptile->AddImage(BitmapImage(L"Images\\flap1.png", L"flap1"));
-	reptile->AddImage(BitmapImage(L"Images\\flap2.png", L"flap2"));
-	reptile->AddImage(BitmapImage(L"Images\\flap3.png", L"flap3"));
-	reptile->AddImage(BitmapImage(L"Images\\flap4.png", L"flap4"));
-	reptile->AddImage(BitmapImage(L"Images\\flap5.png", L"flap5"));
-	reptile->AddImage(BitmapImage(L"Images\\dead.png", L"dead"));
-
-	// create box objects
-	boxes[0] = new Box(L"Images\\box.png", L"topBox", (int)(WINDOW_WIDTH * 0.4), (int)(WINDOW_HEIGHT * 0.53));
-	boxes[1] = new Box(L"Images\\box.png", L"midLeftBox", (int)(WINDOW_WIDTH * 0.35), (int)(WINDOW_HEIGHT * 0.645));
-	boxes[2] = new Box(L"Images\\box.png", L"midRightBox", (int)(WINDOW_WIDTH * 0.45), (int)(WINDOW_HEIGHT * 0.645));
-	boxes[3] = new Box(L"Images\\box.png", L"botLeftBox", (int)(WINDOW_WIDTH * 0.3), (int)(WINDOW_HEIGHT * 0.76));
-	boxes[4] = new Box(L"Images\\box.png", L"botCenterBox", (int)(WINDOW_WIDTH * 0.4), (int)(WINDOW_HEIGHT * 0.76));
-	boxes[5] = new Box(L"Images\\box.png", L"botRightBox", (int)(WINDOW_WIDTH * 0.5), (int)(WINDOW_HEIGHT * 0.76));
+	// the cursor is small, so scale it with the best filter
+	slingshot->SetFilter(Resampler::FILTER_LANCZOS3);
+	slingshot->SetMipmapped(true);
+	// the cursor is mostly transparent, so skip its empty pixels when drawing it
+	slingshot->SetSpanEncoded(true);
+
+	// create reptile images
+	reptileImage = new CompositeImage();
+	reptileFrames[Reptile::FRAME_FLAP0] = reptileImage->AddImage(BitmapImage(L"Images\\flap0.png", L"flap0"));
+	reptileFrames[Reptile::FRAME_FLAP1] = reptileImage->AddImage(BitmapImage(L"Images\\flap1.png", L"flap1"));
+	reptileFrames[Reptile::FRAME_FLAP2] = reptileImage->AddImage(BitmapImage(L"Images\\flap2.png", L"flap2"));
+	reptileFrames[Reptile::FRAME_FLAP3] = reptileImage->AddImage(BitmapImage(L"Images\\flap3.png", L"flap3"));
+	reptileFrames[Reptile::FRAME_FLAP4] = reptileImage->AddImage(BitmapImage(L"Images\\flap4.png", L"flap4"));
+	reptileFrames[Reptile::FRAME_FLAP5] = reptileImage->AddImage(BitmapImage(L"Images\\flap5.png", L"flap5"));
+	reptileFrames[Reptile::FRAME_DEAD] = reptileImage->AddImage(BitmapImage(L"Images\\dead.png", L"dead"));
+	// the sprites are small, so scale them with the best filter
+	reptileImage->SetFilter(Resampler::FILTER_LANCZOS3);
+	// the reptile spins while it falls, so draw its rotations from pre-rotated frames
+	reptileImage->SetRotationCached(true);
+	reptileImage->SetSpanEncoded(true);
+	// shots are tested against the solid pixels of the reptile frames, and nothing else
+	reptileImage->SetHitTested(true);
+
+	// create box image, drawn once for every box in the world
+	boxImage = new BitmapImage(L"Images\\box.png", L"box");
+	boxImage->SetSpanEncoded(true);
+
+	// create game state with the boxes sized to fit their image
+	world = new World(WINDOW_WIDTH, WINDOW_HEIGHT, (unsigned)time(0));
+	world->SetBoxSize(boxImage->GetWidth(), boxImage->GetHeight());
+	// replace the pyramid with the structures described in a file, if one was passed on the command line
+	if (structurePath.empty() == false)
+	{
+		std::ifstream file(structurePath.c_str());
+		std::stringstream description;
+		description << file.rdbuf();
+		if (file.is_open() == false || world->LoadStructure(description.str()) == false)
+		{
+			MessageBox(NULL, L"The box structure file could not be read", L"Box Structure", MB_ICONWARNING);
+		}
+	}
+	world->SetSwarmSize(swarmSize, (unsigned)time(0));
+	// solve the boxes on the drawing threads, which are idle while the world steps
+	world->SetThreadPool(drawPool);
+	// test shots against the solid pixels of the reptile frames, whose masks are rebuilt whenever they are resized
+	for (int i = 0; i < Reptile::FRAME_COUNT; i++)
+	{
+		world->SetFrameMask((Reptile::Frame)i, reptileImage->GetBitmapImage(reptileFrames[i])->GetHitMask());
+	}
 
 	// create flash BitmapImage object displayed for a frame when the reptile is hit
 	flash = new BitmapImage(L"Images\\flash.png", L"flash");
+	flash->SetSpanEncoded(true);
+
+	// pack the small sprites into an atlas, repacked whenever they are resized
+	atlas = new SpriteAtlas();
+	BuildAtlas();
 
 	// set interval for scoreboard to refresh
 	Scoreboard::SECOND_LIMIT = 33;
@@ -423,15 +672,23 @@ void LoadResources(HWND hWnd)
 */
 void UnloadResources(void) 
 {
+	// finish rescaling before the images are freed
+	delete rescaler;
+	delete threadPool;
+	delete renderQueue;
+	delete compositor;
+	delete drawPool;
+
 	// free game object pointers
 	delete background;
 	delete slingshot;
-	delete reptile;
-	for (int i = 0; i < 6; i++)
-	{
-		delete boxes[i];
-	}
+	delete reptileImage;
+	delete atlas;
+	delete boxImage;
 	delete flash;
+	delete world;
+	delete renderTarget;
+	delete dirtyRegion;
 
 	// stop gdi+
 	GdiplusShutdown(gdiplusToken);	
@@ -0,0 +1,792 @@
+#include "PixelSurface.h"
+#include <cstring>
+#include <cmath>
+#include <utility>
+
+
+// class constants
+const int PixelSurface::ALIGNMENT = 32;
+
+
+/**
+\brief		Constructs an empty PixelSurface object.
+*/
+PixelSurface::PixelSurface(void)
+{
+	pixels = nullptr;
+	memory = nullptr;
+	width = 0;
+	height = 0;
+	stride = 0;
+	ResetClip();
+}
+
+
+/**
+\brief		Constructs a PixelSurface object with the passed width and height, cleared to transparent.
+\param[in]	surfaceWidth The width of the surface in pixels.
+\param[in]	surfaceHeight The height of the surface in pixels.
+*/
+PixelSurface::PixelSurface(int surfaceWidth, int surfaceHeight)
+{
+	pixels = nullptr;
+	memory = nullptr;
+	width = 0;
+	height = 0;
+	stride = 0;
+	ResetClip();
+	Create(surfaceWidth, surfaceHeight);
+}
+
+
+/**
+\brief		Constructs a PixelSurface object by taking the pixels of the passed surface.
+\details	The passed surface is left empty.
+\param[in]	surface The surface to take the pixels from.
+*/
+PixelSurface::PixelSurface(PixelSurface&& surface)
+{
+	pixels = nullptr;
+	memory = nullptr;
+	width = 0;
+	height = 0;
+	stride = 0;
+	ResetClip();
+	*this = std::move(surface);
+}
+
+
+/**
+\brief		Replaces the pixels of the PixelSurface with the pixels of the passed surface.
+\details	The pixels are not copied, the passed surface hands them over and is left empty.
+\param[in]	surface The surface to take the pixels from.
+\return		A reference to this surface.
+*/
+PixelSurface& PixelSurface::operator=(PixelSurface&& surface)
+{
+	if (this != &surface)
+	{
+		Release();
+		pixels = surface.pixels;
+		memory = surface.memory;
+		width = surface.width;
+		height = surface.height;
+		stride = surface.stride;
+		clip = surface.clip;
+		surface.pixels = nullptr;
+		surface.memory = nullptr;
+		surface.Release();
+	}
+	return *this;
+}
+
+
+/**
+\brief		Destructor for a PixelSurface. Frees the pixels if they are owned by the surface.
+*/
+PixelSurface::~PixelSurface(void)
+{
+	Release();
+}
+
+
+/**
+\brief		Allocates pixels for the passed width and height, cleared to transparent.
+\details	Any previous pixels are released first. Rows are padded so the stride is a multiple of
+			ALIGNMENT bytes, and the block is over-allocated so the first pixel can be aligned.
+\param[in]	surfaceWidth The width of the surface in pixels.
+\param[in]	surfaceHeight The height of the surface in pixels.
+*/
+void PixelSurface::Create(int surfaceWidth, int surfaceHeight)
+{
+	Release();
+	if (surfaceWidth <= 0 || surfaceHeight <= 0)
+	{
+		return;
+	}
+	width = surfaceWidth;
+	height = surfaceHeight;
+	stride = PaddedStride(width);
+	size_t size = (size_t)stride * height * sizeof(unsigned int);
+	memory = new unsigned char[size + ALIGNMENT];
+	size_t offset = ALIGNMENT - (size_t)memory % ALIGNMENT;
+	pixels = (unsigned int*)(memory + offset);
+	memset(pixels, 0, size);
+	ResetClip();
+}
+
+
+/**
+\brief		Uses pixel memory owned by someone else as the pixels of the surface.
+\details	The memory is not freed by the surface and must outlive it, or be detached with Release.
+\param[in]	surfacePixels The first pixel of the memory.
+\param[in]	surfaceWidth The width of the memory in pixels.
+\param[in]	surfaceHeight The height of the memory in pixels.
+\param[in]	surfaceStride The distance between rows of the memory in pixels.
+*/
+void PixelSurface::Attach(unsigned int* surfacePixels, int surfaceWidth, int surfaceHeight, int surfaceStride)
+{
+	Release();
+	pixels = surfacePixels;
+	width = surfaceWidth;
+	height = surfaceHeight;
+	stride = surfaceStride;
+	ResetClip();
+}
+
+
+/**
+\brief		Frees the pixels if they are owned by the surface and leaves the surface empty.
+*/
+void PixelSurface::Release(void)
+{
+	delete[] memory;
+	memory = nullptr;
+	pixels = nullptr;
+	width = 0;
+	height = 0;
+	stride = 0;
+	ResetClip();
+}
+
+
+/**
+\brief		Replaces the pixels of the PixelSurface with a copy of the pixels of the passed surface.
+\details	The copy always owns its pixels, even if the passed surface has attached pixels.
+\param[in]	surface The surface to copy.
+*/
+void PixelSurface::CopyFrom(const PixelSurface* surface)
+{
+	if (this == surface)
+	{
+		return;
+	}
+	Create(surface->width, surface->height);
+	for (int y = 0; y < height; y++)
+	{
+		memcpy(pixels + y * stride, surface->pixels + y * surface->stride, width * sizeof(unsigned int));
+	}
+}
+
+
+#ifndef _WIN32
+/**
+rief		Leaves the surface empty, since image files are decoded with GDI+ and there is none here.
+\details	GdiSurface.cpp implements Load on Windows. This stub lets the renderer be built and tested
+			on other platforms, where the images are drawn from surfaces filled in code instead.
+eturn		False, the image is never loaded.
+*/
+bool PixelSurface::Load(wstring)
+{
+	Release();
+	return false;
+}
+#endif
+
+
+/**
+\brief		Limits drawing on the surface to the passed rectangle.
+\details	The rectangle is clipped to the bounds of the surface. Every drawing method except 
+			Clear leaves the pixels outside the clip rectangle untouched.
+\param[in]	rect The rectangle to limit drawing to.
+*/
+void PixelSurface::SetClip(const PixelRect* rect)
+{
+	int left = rect->x > 0 ? rect->x : 0;
+	int top = rect->y > 0 ? rect->y : 0;
+	int right = rect->x + rect->width < width ? rect->x + rect->width : width;
+	int bottom = rect->y + rect->height < height ? rect->y + rect->height : height;
+	clip.x = left;
+	clip.y = top;
+	clip.width = right > left ? right - left : 0;
+	clip.height = bottom > top ? bottom - top : 0;
+}
+
+
+/**
+\brief		Sets the clip rectangle back to the whole surface.
+*/
+void PixelSurface::ResetClip(void)
+{
+	clip.x = 0;
+	clip.y = 0;
+	clip.width = width;
+	clip.height = height;
+}
+
+
+/**
+\brief		Clips a source rectangle drawn at the passed coordinates to the clip rectangle.
+\param[in,out]	x The X coordinate to draw at, moved inside the clip rectangle.
+\param[in,out]	y The Y coordinate to draw at, moved inside the clip rectangle.
+\param[out]	sx The X coordinate in the source of the first pixel to draw.
+\param[out]	sy The Y coordinate in the source of the first pixel to draw.
+\param[in,out]	w The width of the source, reduced to the width to draw.
+\param[in,out]	h The height of the source, reduced to the height to draw.
+\return		True if any part of the source is inside the clip rectangle.
+*/
+bool PixelSurface::ClipToDest(int& x, int& y, int& sx, int& sy, int& w, int& h)
+{
+	sx = 0;
+	sy = 0;
+	if (x < clip.x)
+	{
+		sx = clip.x - x;
+		w -= sx;
+		x = clip.x;
+	}
+	if (y < clip.y)
+	{
+		sy = clip.y - y;
+		h -= sy;
+		y = clip.y;
+	}
+	if (x + w > clip.x + clip.width)
+	{
+		w = clip.x + clip.width - x;
+	}
+	if (y + h > clip.y + clip.height)
+	{
+		h = clip.y + clip.height - y;
+	}
+	return w > 0 && h > 0;
+}
+
+
+/**
+\brief		Sets every pixel of the surface to the passed color.
+\param[in]	color The premultiplied ARGB color to fill the surface with.
+*/
+void PixelSurface::Clear(unsigned int color)
+{
+	for (int y = 0; y < height; y++)
+	{
+		unsigned int* row = pixels + y * stride;
+		for (int x = 0; x < width; x++)
+		{
+			row[x] = color;
+		}
+	}
+}
+
+
+/**
+\brief		Copies the pixels of the source surface onto the surface, replacing what is underneath.
+\param[in]	source The surface to copy from.
+\param[in]	x The X coordinate to copy the source to.
+\param[in]	y The Y coordinate to copy the source to.
+*/
+void PixelSurface::Copy(const PixelSurface* source, int x, int y)
+{
+	BlitRect<BLEND_COPY>(this, source, x, y, 0, NULL);
+}
+
+
+/**
+\brief		Draws the source surface onto the surface using its alpha channel.
+\param[in]	source The surface to draw.
+\param[in]	x The X coordinate to draw the source at.
+\param[in]	y The Y coordinate to draw the source at.
+*/
+void PixelSurface::Blend(const PixelSurface* source, int x, int y)
+{
+	BlitRect<BLEND_ALPHA>(this, source, x, y, 0, NULL);
+}
+
+
+/**
+\brief		Draws the source surface onto the surface, leaving out the pixels in the color key range.
+\param[in]	source The surface to draw.
+\param[in]	x The X coordinate to draw the source at.
+\param[in]	y The Y coordinate to draw the source at.
+\param[in]	key The range of colors to draw as transparent.
+*/
+void PixelSurface::BlendKeyed(const PixelSurface* source, int x, int y, const ColorKey* key)
+{
+	BlitRect<BLEND_KEYED>(this, source, x, y, 0, key);
+}
+
+
+/**
+\brief		Adds the source surface onto the surface, brightening what is underneath.
+\param[in]	source The surface to draw.
+\param[in]	x The X coordinate to draw the source at.
+\param[in]	y The Y coordinate to draw the source at.
+*/
+void PixelSurface::BlendAdd(const PixelSurface* source, int x, int y)
+{
+	BlitRect<BLEND_ADD>(this, source, x, y, 0, NULL);
+}
+
+
+/**
+\brief		Draws the source surface onto the surface rotated about its center.
+\details	Positive degrees rotate clockwise on screen, matching Gdiplus::Matrix::RotateAt.
+\param[in]	source The surface to draw.
+\param[in]	x The X coordinate of the unrotated source.
+\param[in]	y The Y coordinate of the unrotated source.
+\param[in]	degrees The rotation of the source in degrees.
+\param[in]	sampling Indicates if the nearest source pixel is drawn or the closest 4 are blended.
+*/
+void PixelSurface::BlendRotated(const PixelSurface* source, int x, int y, int degrees, Sampling sampling)
+{
+	SelectBlitter(BLEND_ALPHA, true, sampling)(this, source, x, y, degrees, NULL);
+}
+
+
+/**
+\brief		Picks the blit kernel specialized for the passed blend mode, rotation and sampling.
+\details	Every kernel is generated from the same two templates, one for unrotated and one for
+			rotated sources, with the blend mode and sampling fixed at compile time, so the inner loops 
+			carry no mode branches. A sprite can pick its kernel once, when its properties change, and
+			call it on every draw. Clipping is resolved once per call or per row, never per pixel:
+			BlitRect intersects the source with the clip rectangle once, and BlitRotated narrows each
+			row with ClipSpan before its inner loop. So the kernels are not also specialized for
+			clipped and unclipped draws, which would double their number to save one intersection per
+			call or per row, and no work for any pixel.
+\param[in]	mode How the source pixels are combined with the pixels underneath.
+\param[in]	isRotated Indicates if the kernel rotates the source, the degrees are ignored otherwise.
+\param[in]	sampling How a rotated source is sampled, ignored if the kernel does not rotate.
+\return		The kernel, which is passed the target, source, position, degrees and color key.
+*/
+PixelSurface::Blitter PixelSurface::SelectBlitter(BlendMode mode, bool isRotated, Sampling sampling)
+{
+	static const Blitter blitters[BLEND_MODE_COUNT][3] =
+	{
+		{ BlitRect<BLEND_COPY>, BlitRotated<BLEND_COPY, SAMPLING_NEAREST>, BlitRotated<BLEND_COPY, SAMPLING_BILINEAR> },
+		{ BlitRect<BLEND_KEYED>, BlitRotated<BLEND_KEYED, SAMPLING_NEAREST>, BlitRotated<BLEND_KEYED, SAMPLING_BILINEAR> },
+		{ BlitRect<BLEND_ALPHA>, BlitRotated<BLEND_ALPHA, SAMPLING_NEAREST>, BlitRotated<BLEND_ALPHA, SAMPLING_BILINEAR> },
+		{ BlitRect<BLEND_ADD>, BlitRotated<BLEND_ADD, SAMPLING_NEAREST>, BlitRotated<BLEND_ADD, SAMPLING_BILINEAR> }
+	};
+	int variant = 0;
+	if (isRotated == true)
+	{
+		variant = sampling == SAMPLING_NEAREST ? 1 : 2;
+	}
+	return blitters[mode][variant];
+}
+
+
+/**
+\brief		Combines a source pixel with the pixel underneath it using the blend mode of the kernel.
+\details	Copy replaces the pixel, keyed blends it unless its red, green and blue channels are all
+			in the key range, alpha blends it and add sums each channel, saturating at 255. None of the
+			modes branch on the pixel, since BlendPixel is already exact for opaque and transparent 
+			pixels, so the compiler can vectorize the loops that call it.
+\param[in]	source The pixel being drawn.
+\param[in]	dest The pixel underneath.
+\param[in]	key The range of colors left out by the keyed mode.
+\return		The combined pixel.
+*/
+template <PixelSurface::BlendMode mode>
+inline unsigned int PixelSurface::Combine(unsigned int source, unsigned int dest, ColorKey key)
+{
+	if (mode == BLEND_COPY)
+	{
+		return source;
+	}
+	if (mode == BLEND_KEYED)
+	{
+		unsigned int r = (source >> 16) & 0xff;
+		unsigned int g = (source >> 8) & 0xff;
+		unsigned int b = source & 0xff;
+		bool isKeyed = r >= ((key.low >> 16) & 0xff) && r <= ((key.high >> 16) & 0xff) &&
+			g >= ((key.low >> 8) & 0xff) && g <= ((key.high >> 8) & 0xff) &&
+			b >= (key.low & 0xff) && b <= (key.high & 0xff);
+		return isKeyed == true ? dest : BlendPixel(source, dest);
+	}
+	if (mode == BLEND_ADD)
+	{
+		// a channel that carries into bit 8 is set to 255
+		unsigned int rb = (source & 0x00ff00ff) + (dest & 0x00ff00ff);
+		rb = (rb | (0x01000100 - ((rb >> 8) & 0x00010001))) & 0x00ff00ff;
+		unsigned int ag = ((source >> 8) & 0x00ff00ff) + ((dest >> 8) & 0x00ff00ff);
+		ag = (ag | (0x01000100 - ((ag >> 8) & 0x00010001))) & 0x00ff00ff;
+		return rb | (ag << 8);
+	}
+	return BlendPixel(source, dest);
+}
+
+
+/**
+\brief		Draws an unrotated source surface onto a target surface with the blend mode of the kernel.
+\param[in]	target The surface to draw onto, limited to its clip rectangle.
+\param[in]	source The surface to draw.
+\param[in]	x The X coordinate to draw the source at.
+\param[in]	y The Y coordinate to draw the source at.
+\param[in]	degrees Ignored, the source is not rotated.
+\param[in]	key The range of colors left out by the keyed mode, NULL for the other modes.
+*/
+template <PixelSurface::BlendMode mode>
+void PixelSurface::BlitRect(PixelSurface* target, const PixelSurface* source, int x, int y, int /*degrees*/, const ColorKey* key)
+{
+	int sx, sy;
+	int w = source->width;
+	int h = source->height;
+	if (target->ClipToDest(x, y, sx, sy, w, h) == false)
+	{
+		return;
+	}
+	// a local copy of the key, which the compiler knows no pixel write can change
+	ColorKey range = { 0, 0 };
+	if (key != NULL)
+	{
+		range = *key;
+	}
+	for (int row = 0; row < h; row++)
+	{
+		unsigned int* dest = target->GetRow(y + row) + x;
+		const unsigned int* src = source->GetRow(sy + row) + sx;
+		if (mode == BLEND_COPY)
+		{
+			memcpy(dest, src, w * sizeof(unsigned int));
+			continue;
+		}
+		for (int i = 0; i < w; i++)
+		{
+			dest[i] = Combine<mode>(src[i], dest[i], range);
+		}
+	}
+}
+
+
+/**
+\brief		Draws a source surface rotated about its center onto a target surface with the blend mode
+			and sampling of the kernel.
+\details	Each row of the bounding box of the rotated source is mapped back into the source once, 
+			and the source position is then stepped across the row in 16.16 fixed point. Each row is
+			clipped to the span that lands inside the source before any pixel is touched, so the
+			inner loop needs no bounds checks, and fully transparent source pixels are skipped unless
+			they are copied. Rows are clipped to the source rectangle rather than to the opaque extents
+			of the source rows: a rotated row crosses many source rows, so its opaque span would have to
+			be worked out from the extents of each of them, the copy mode must write the transparent
+			pixels anyway, and bilinear sampling blends pixels just outside an opaque extent with the
+			pixels inside it. A transparent pixel inside the rectangle costs a read and a compare.
+\param[in]	target The surface to draw onto, limited to its clip rectangle.
+\param[in]	source The surface to draw.
+\param[in]	x The X coordinate of the unrotated source.
+\param[in]	y The Y coordinate of the unrotated source.
+\param[in]	degrees The rotation of the source in degrees.
+\param[in]	key The range of colors left out by the keyed mode, NULL for the other modes.
+*/
+template <PixelSurface::BlendMode mode, PixelSurface::Sampling sampling>
+void PixelSurface::BlitRotated(PixelSurface* target, const PixelSurface* source, int x, int y, int degrees, const ColorKey* key)
+{
+	if (source->IsEmpty() == true)
+	{
+		return;
+	}
+	ColorKey range = { 0, 0 };
+	if (key != NULL)
+	{
+		range = *key;
+	}
+	double radians = degrees * 3.14159265358979323846 / 180.0;
+	double c = cos(radians);
+	double s = sin(radians);
+	const PixelRect& clip = target->clip;
+	PixelRect bounds = RotatedBounds(x, y, source->width, source->height, degrees);
+	int left = bounds.x > clip.x ? bounds.x : clip.x;
+	int top = bounds.y > clip.y ? bounds.y : clip.y;
+	int right = bounds.x + bounds.width < clip.x + clip.width ? bounds.x + bounds.width : clip.x + clip.width;
+	int bottom = bounds.y + bounds.height < clip.y + clip.height ? bounds.y + bounds.height : clip.y + clip.height;
+	// the source position moves by the same step for every pixel along a row
+	int stepU = (int)floor(c * 65536.0 + 0.5);
+	int stepV = (int)floor(-s * 65536.0 + 0.5);
+	for (int dy = top; dy < bottom; dy++)
+	{
+		// rotate the center of the first pixel of the row back into the source, measured from the 
+		// source position so the source is rotated the same wherever it is drawn
+		double rx = bounds.x - x + 0.5 - source->width / 2.0;
+		double ry = dy - y + 0.5 - source->height / 2.0;
+		long long startU = (long long)floor((rx * c + ry * s + source->width / 2.0) * 65536.0);
+		long long startV = (long long)floor((-rx * s + ry * c + source->height / 2.0) * 65536.0);
+		int first = left - bounds.x;
+		int last = right - bounds.x - 1;
+		ClipSpan(startU, stepU, source->width, &first, &last);
+		ClipSpan(startV, stepV, source->height, &first, &last);
+		int u = (int)(startU + (long long)first * stepU);
+		int v = (int)(startV + (long long)first * stepV);
+		unsigned int* dest = target->GetRow(dy) + bounds.x;
+		for (int i = first; i <= last; i++)
+		{
+			unsigned int pixel;
+			if (sampling == SAMPLING_BILINEAR)
+			{
+				pixel = SampleBilinear(source, u, v);
+			}
+			else
+			{
+				pixel = source->GetRow(v >> 16)[u >> 16];
+			}
+			if (mode == BLEND_COPY || pixel != 0)
+			{
+				dest[i] = Combine<mode>(pixel, dest[i], range);
+			}
+			u += stepU;
+			v += stepV;
+		}
+	}
+}
+
+
+/**
+\brief		Narrows a span of steps along a row to the steps whose source position is inside the source.
+\param[in]	start The source position of step 0 in 16.16 fixed point.
+\param[in]	step The change in source position for each step in 16.16 fixed point.
+\param[in]	size The width or height of the source in pixels.
+\param[in,out]	first The first step of the span, moved forward past positions before the source.
+\param[in,out]	last The last step of the span, moved back past positions after the source.
+*/
+void PixelSurface::ClipSpan(long long start, int step, int size, int* first, int* last)
+{
+	long long limit = ((long long)size << 16) - 1;
+	long long low;
+	long long high;
+	if (step == 0)
+	{
+		if (start < 0 || start > limit)
+		{
+			*last = *first - 1;
+		}
+		return;
+	}
+	// solve 0 <= start + t * step <= limit for t, rounding towards the inside of the span
+	if (step > 0)
+	{
+		low = start >= 0 ? 0 : (-start + step - 1) / step;
+		high = limit - start >= 0 ? (limit - start) / step : -((start - limit + step - 1) / step);
+	}
+	else
+	{
+		low = start - limit <= 0 ? 0 : (start - limit - step - 1) / -step;
+		high = start >= 0 ? start / -step : -((-start - step - 1) / -step);
+	}
+	if (low > *first)
+	{
+		*first = low > *last + 1 ? *last + 1 : (int)low;
+	}
+	if (high < *last)
+	{
+		*last = high < *first - 1 ? *first - 1 : (int)high;
+	}
+}
+
+
+/**
+\brief		Blends the 4 source pixels closest to a source position, weighted by their distance from it.
+\details	Pixels past the edges of the source repeat the edge pixels, so the rotated source covers the
+			same pixels as it does with nearest sampling.
+\param[in]	source The surface to sample.
+\param[in]	u The X position in the source in 16.16 fixed point, inside the source.
+\param[in]	v The Y position in the source in 16.16 fixed point, inside the source.
+\return		The blended pixel.
+*/
+unsigned int PixelSurface::SampleBilinear(const PixelSurface* source, int u, int v)
+{
+	// move to the position relative to pixel centers, which may be up to half a pixel before the source
+	u += 0x8000;
+	v += 0x8000;
+	int x0 = (u >> 16) - 1;
+	int y0 = (v >> 16) - 1;
+	unsigned int fx = (u >> 8) & 0xff;
+	unsigned int fy = (v >> 8) & 0xff;
+	int x1 = x0 + 1 < source->width ? x0 + 1 : x0;
+	int y1 = y0 + 1 < source->height ? y0 + 1 : y0;
+	x0 = x0 < 0 ? 0 : x0;
+	y0 = y0 < 0 ? 0 : y0;
+	const unsigned int* row0 = source->GetRow(y0);
+	const unsigned int* row1 = source->GetRow(y1);
+	unsigned int top = Lerp(row0[x0], row0[x1], fx);
+	unsigned int bottom = Lerp(row1[x0], row1[x1], fx);
+	return Lerp(top, bottom, fy);
+}
+
+
+/**
+\brief		Blends two premultiplied pixels, two channels at a time.
+\details	The result is rounded down, so its color channels never exceed its alpha channel.
+\param[in]	a The pixel returned when the weight is 0.
+\param[in]	b The pixel weighted by the weight.
+\param[in]	weight The weight of pixel b from 0 - 255, out of 256.
+\return		The blended pixel.
+*/
+unsigned int PixelSurface::Lerp(unsigned int a, unsigned int b, unsigned int weight)
+{
+	unsigned int rb = (((a & 0x00ff00ff) * (256 - weight) + (b & 0x00ff00ff) * weight) >> 8) & 0x00ff00ff;
+	unsigned int ag = (((a >> 8) & 0x00ff00ff) * (256 - weight) + ((b >> 8) & 0x00ff00ff) * weight) & 0xff00ff00;
+	return rb | ag;
+}
+
+
+/**
+\brief		Returns a pointer to the first pixel of the surface.
+\return		A pointer to the first pixel.
+*/
+unsigned int* PixelSurface::GetPixels(void)
+{
+	return pixels;
+}
+
+
+/**
+\brief		Returns a pointer to the first pixel of the surface for reading.
+\return		A pointer to the first pixel.
+*/
+const unsigned int* PixelSurface::GetPixels(void) const
+{
+	return pixels;
+}
+
+
+/**
+\brief		Returns a pointer to the first pixel of the passed row.
+\param[in]	y The row of the surface.
+\return		A pointer to the first pixel of the row.
+*/
+unsigned int* PixelSurface::GetRow(int y)
+{
+	return pixels + (size_t)y * stride;
+}
+
+
+/**
+\brief		Returns a pointer to the first pixel of the passed row for reading.
+\param[in]	y The row of the surface.
+\return		A pointer to the first pixel of the row.
+*/
+const unsigned int* PixelSurface::GetRow(int y) const
+{
+	return pixels + (size_t)y * stride;
+}
+
+
+/**
+\brief		Returns the width of the surface.
+\return		The width of the surface in pixels.
+*/
+int PixelSurface::GetWidth(void) const
+{
+	return width;
+}
+
+
+/**
+\brief		Returns the height of the surface.
+\return		The height of the surface in pixels.
+*/
+int PixelSurface::GetHeight(void) const
+{
+	return height;
+}
+
+
+/**
+\brief		Returns the distance between rows of the surface.
+\return		The stride of the surface in pixels.
+*/
+int PixelSurface::GetStride(void) const
+{
+	return stride;
+}
+
+
+/**
+\brief		Returns the rectangle that drawing is limited to.
+\return		The clip rectangle of the surface.
+*/
+PixelRect PixelSurface::GetClip(void) const
+{
+	return clip;
+}
+
+
+/**
+\brief		Checks if the surface has any pixels.
+\return		True if the surface has no pixels.
+*/
+bool PixelSurface::IsEmpty(void) const
+{
+	return pixels == nullptr || width == 0 || height == 0;
+}
+
+
+/**
+\brief		Returns the bounding box of a rectangle rotated about its center.
+\details	This is the area BlendRotated draws over for a source of the passed size.
+\param[in]	x The X coordinate of the unrotated rectangle.
+\param[in]	y The Y coordinate of the unrotated rectangle.
+\param[in]	w The width of the unrotated rectangle.
+\param[in]	h The height of the unrotated rectangle.
+\param[in]	degrees The rotation of the rectangle in degrees.
+\return		The smallest rectangle of whole pixels containing the rotated rectangle.
+*/
+PixelRect PixelSurface::RotatedBounds(int x, int y, int w, int h, int degrees)
+{
+	double radians = degrees * 3.14159265358979323846 / 180.0;
+	double c = fabs(cos(radians));
+	double s = fabs(sin(radians));
+	double centerX = w / 2.0;
+	double centerY = h / 2.0;
+	// half the width and height of the rotated bounding box
+	double halfW = (w * c + h * s) / 2.0;
+	double halfH = (w * s + h * c) / 2.0;
+	// found relative to the rectangle's position, so rounding never depends on where it is
+	PixelRect bounds;
+	bounds.x = (int)floor(centerX - halfW);
+	bounds.y = (int)floor(centerY - halfH);
+	bounds.width = (int)ceil(centerX + halfW) - bounds.x;
+	bounds.height = (int)ceil(centerY + halfH) - bounds.y;
+	bounds.x += x;
+	bounds.y += y;
+	return bounds;
+}
+
+
+/**
+\brief		Returns the stride Create gives a surface of the passed width, padded to a multiple of ALIGNMENT
+			bytes, so the memory of a surface can be known before it is created.
+\param[in]	surfaceWidth The width of the surface in pixels.
+\return		The stride in pixels.
+*/
+int PixelSurface::PaddedStride(int surfaceWidth)
+{
+	int pixelsPerAlignment = ALIGNMENT / sizeof(unsigned int);
+	return (surfaceWidth + pixelsPerAlignment - 1) / pixelsPerAlignment * pixelsPerAlignment;
+}
+
+
+/**
+\brief		Builds a premultiplied ARGB pixel from straight alpha, red, green and blue channels.
+\param[in]	a The alpha channel from 0 - 255.
+\param[in]	r The red channel from 0 - 255.
+\param[in]	g The green channel from 0 - 255.
+\param[in]	b The blue channel from 0 - 255.
+\return		The premultiplied ARGB pixel.
+*/
+unsigned int PixelSurface::MakeArgb(int a, int r, int g, int b)
+{
+	r = (r * a + 127) / 255;
+	g = (g * a + 127) / 255;
+	b = (b * a + 127) / 255;
+	return ((unsigned int)a << 24) | ((unsigned int)r << 16) | ((unsigned int)g << 8) | (unsigned int)b;
+}
+
+
+/**
+\brief		Blends a premultiplied source pixel over a premultiplied destination pixel.
+\details	Works on the red and blue channels and on the alpha and green channels two at a time,
+			and divides by 255 with rounding so that opaque and transparent pixels are exact.
+\param[in]	source The pixel being drawn.
+\param[in]	dest The pixel underneath.
+\return		The blended pixel.
+*/
+unsigned int PixelSurface::BlendPixel(unsigned int source, unsigned int dest)
+{
+	unsigned int inverseAlpha = 255 - (source >> 24);
+	unsigned int rb = (dest & 0x00ff00ff) * inverseAlpha + 0x00800080;
+	rb = ((rb + ((rb >> 8) & 0x00ff00ff)) >> 8) & 0x00ff00ff;
+	unsigned int ag = ((dest >> 8) & 0x00ff00ff) * inverseAlpha + 0x00800080;
+	ag = (ag + ((ag >> 8) & 0x00ff00ff)) & 0xff00ff00;
+	return source + rb + ag;
+}
\ No newline at end of file
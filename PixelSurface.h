@@ -0,0 +1,138 @@
+#include <string>
+using namespace std;
+
+
+#ifndef __PIXEL_SURFACE_H__
+#define __PIXEL_SURFACE_H__
+
+
+/**
+\struct		ColorKey
+\brief		A range of colors that are drawn as transparent.
+\details	A pixel is keyed out when each of its red, green and blue channels lies between the matching
+			channels of the low and high colors, the same test as Gdiplus::ImageAttributes::SetColorKey.
+*/
+struct ColorKey
+{
+	unsigned int low;					// the lowest color in the key range
+	unsigned int high;					// the highest color in the key range
+};
+
+
+/**
+\struct		PixelRect
+\brief		A rectangle of pixels on a PixelSurface.
+*/
+struct PixelRect
+{
+	int x;								// the X coordinate of the left edge
+	int y;								// the Y coordinate of the top edge
+	int width;							// the width of the rectangle
+	int height;							// the height of the rectangle
+};
+
+
+/**
+\class		PixelSurface
+\author		Tom Bisch
+\date		Apr 19, 2016
+\brief		A block of 32-bit premultiplied ARGB pixels that images are stored in and drawn onto.
+\details	A PixelSurface keeps its pixels in one contiguous block whose first pixel is aligned to 
+			ALIGNMENT bytes, with each row padded to a multiple of ALIGNMENT bytes so that every row 
+			starts aligned as well. The pixels can be owned by the surface or attached from memory 
+			owned by someone else, such as a window's back buffer. All drawing is done in software
+			directly on the pixel memory, so the surface does not depend on a window or on GDI+.
+			Drawing is limited to the clip rectangle, which covers the whole surface unless it is set.
+			Surfaces are drawn by blit kernels generated from templates for every blend mode, rotation 
+			and sampling, which can be picked once with SelectBlitter and called on every draw.
+			A PixelSurface can be moved but not copied, so its pixels are only ever copied by CopyFrom.
+*/
+class PixelSurface
+{
+
+public:
+	// how a rotated surface picks the color of each pixel it covers
+	enum Sampling
+	{
+		SAMPLING_NEAREST,
+		SAMPLING_BILINEAR
+	};
+
+	// how the pixels of a source surface are combined with the pixels underneath
+	enum BlendMode
+	{
+		BLEND_COPY,
+		BLEND_KEYED,
+		BLEND_ALPHA,
+		BLEND_ADD,
+		BLEND_MODE_COUNT
+	};
+
+	// a blit kernel taking the target, source, position, degrees and color key
+	typedef void (*Blitter)(PixelSurface* target, const PixelSurface* source, int x, int y, int degrees, const ColorKey* key);
+
+private:
+	unsigned int* pixels;				// the first pixel of the surface
+	unsigned char* memory;				// the block allocated by the surface, NULL if the pixels are attached
+	int width;							// the width of the surface in pixels
+	int height;							// the height of the surface in pixels
+	int stride;							// the distance between rows in pixels
+	PixelRect clip;						// the rectangle that drawing is limited to
+
+	bool ClipToDest(int& x, int& y, int& sx, int& sy, int& w, int& h);
+
+	template <BlendMode mode> static unsigned int Combine(unsigned int source, unsigned int dest, ColorKey key);
+	template <BlendMode mode> static void BlitRect(PixelSurface* target, const PixelSurface* source, int x, int y, 
+		int degrees, const ColorKey* key);
+	template <BlendMode mode, Sampling sampling> static void BlitRotated(PixelSurface* target, const PixelSurface* source, 
+		int x, int y, int degrees, const ColorKey* key);
+	static void ClipSpan(long long start, int step, int size, int* first, int* last);
+	static unsigned int SampleBilinear(const PixelSurface* source, int u, int v);
+	static unsigned int Lerp(unsigned int a, unsigned int b, unsigned int weight);
+
+public:
+	static const int ALIGNMENT;			// the alignment of the pixels and rows in bytes
+
+	PixelSurface(void);
+	PixelSurface(int surfaceWidth, int surfaceHeight);
+	PixelSurface(PixelSurface&& surface);
+	PixelSurface& operator=(PixelSurface&& surface);
+	PixelSurface(const PixelSurface& surface) = delete;
+	PixelSurface& operator=(const PixelSurface& surface) = delete;
+	~PixelSurface(void);
+
+	void Create(int surfaceWidth, int surfaceHeight);
+	void Attach(unsigned int* surfacePixels, int surfaceWidth, int surfaceHeight, int surfaceStride);
+	void Release(void);
+	void CopyFrom(const PixelSurface* surface);
+	bool Load(wstring path);
+
+	void SetClip(const PixelRect* rect);
+	void ResetClip(void);
+	void Clear(unsigned int color);
+	void Copy(const PixelSurface* source, int x, int y);
+	void Blend(const PixelSurface* source, int x, int y);
+	void BlendKeyed(const PixelSurface* source, int x, int y, const ColorKey* key);
+	void BlendAdd(const PixelSurface* source, int x, int y);
+	void BlendRotated(const PixelSurface* source, int x, int y, int degrees, Sampling sampling = SAMPLING_NEAREST);
+
+	unsigned int* GetPixels(void);
+	const unsigned int* GetPixels(void) const;
+	unsigned int* GetRow(int y);
+	const unsigned int* GetRow(int y) const;
+	int GetWidth(void) const;
+	int GetHeight(void) const;
+	int GetStride(void) const;
+	PixelRect GetClip(void) const;
+	bool IsEmpty(void) const;
+
+	static Blitter SelectBlitter(BlendMode mode, bool isRotated, Sampling sampling);
+	static PixelRect RotatedBounds(int x, int y, int w, int h, int degrees);
+	static int PaddedStride(int surfaceWidth);
+	static unsigned int MakeArgb(int a, int r, int g, int b);
+	static unsigned int BlendPixel(unsigned int source, unsigned int dest);
+
+};
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,298 @@
+#include "RenderQueue.h"
+#include <algorithm>
+
+
+/**
+\brief		Constructs an empty RenderQueue object.
+*/
+RenderQueue::RenderQueue(void)
+{
+	batchCount = 0;
+}
+
+
+/**
+\brief		Destructor for a RenderQueue. The sprites belong to their images.
+*/
+RenderQueue::~RenderQueue(void)
+{
+}
+
+
+/**
+\brief		Adds a command drawing the passed sprite where it is now, as it would be drawn by Draw.
+\param[in]	sprite The sprite to draw, which must have a surface.
+\param[in]	layer The layer to draw the sprite in.
+*/
+void RenderQueue::Submit(BitmapImage* sprite, int layer)
+{
+	Submit(sprite, sprite->GetXPos(), sprite->GetYPos(), sprite->GetRotation(), layer);
+}
+
+
+/**
+\brief		Adds a command drawing the passed sprite at the passed position and rotation, without moving it.
+\details	Lets one sprite be drawn for many game objects, such as every reptile of a flock.
+\param[in]	sprite The sprite to draw, which must have a surface.
+\param[in]	x The X coordinate to draw the unrotated sprite at.
+\param[in]	y The Y coordinate to draw the unrotated sprite at.
+\param[in]	degrees The rotation to draw the sprite at, which may be negative.
+\param[in]	layer The layer to draw the sprite in.
+*/
+void RenderQueue::Submit(BitmapImage* sprite, int x, int y, int degrees, int layer)
+{
+	DrawCommand command;
+	command.sprite = sprite;
+	command.surface = sprite->GetSurface();
+	command.x = x;
+	command.y = y;
+	command.rotation = (degrees % 360 + 360) % 360;
+	command.layer = layer;
+	command.blendMode = sprite->GetBlendMode();
+	command.batch = 0;
+	command.sequence = commands.size();
+	commands.push_back(command);
+}
+
+
+/**
+\brief		Adds the commands drawing the passed CompositeImage where it is now, as it would be drawn by Draw.
+\details	A cached CompositeImage is drawn by copying its flattened cache, rebuilt here if it has been
+			invalidated, and any other CompositeImage by drawing each of its bitmaps in order.
+\param[in]	image The CompositeImage to draw.
+\param[in]	layer The layer to draw the CompositeImage in.
+*/
+void RenderQueue::Submit(CompositeImage* image, int layer)
+{
+	const PixelSurface* cache = image->GetCache();
+	if (cache != NULL)
+	{
+		SubmitSurface(cache, image->GetXPos(), image->GetYPos(), layer, PixelSurface::BLEND_COPY);
+		return;
+	}
+	std::vector<BitmapImage*> bitmaps;
+	image->GetBitmapImages(&bitmaps);
+	for (unsigned int i = 0; i < bitmaps.size(); i++)
+	{
+		Submit(bitmaps[i], layer);
+	}
+}
+
+
+/**
+\brief		Adds a command blitting the passed surface unrotated, without a sprite.
+\param[in]	surface The surface to draw, which must live until the command is drawn.
+\param[in]	x The X coordinate to draw the surface at.
+\param[in]	y The Y coordinate to draw the surface at.
+\param[in]	layer The layer to draw the surface in.
+\param[in]	mode How the surface is combined with the pixels underneath, other than keyed.
+*/
+void RenderQueue::SubmitSurface(const PixelSurface* surface, int x, int y, int layer, PixelSurface::BlendMode mode)
+{
+	DrawCommand command;
+	command.sprite = NULL;
+	command.surface = surface;
+	command.x = x;
+	command.y = y;
+	command.rotation = 0;
+	command.layer = layer;
+	command.blendMode = mode;
+	command.batch = 0;
+	command.sequence = commands.size();
+	commands.push_back(command);
+}
+
+
+/**
+\brief		Draws the commands of a layer in the order they were submitted instead of grouping their surfaces.
+\details	For layers whose sprites overlap and are drawn from several surfaces, such as a flock of
+			reptiles flapping out of step, where the order decides which sprite is on top. The layer
+			keeps its order for every frame after, as Clear only removes the commands.
+\param[in]	layer The layer to keep in order.
+*/
+void RenderQueue::KeepOrder(int layer)
+{
+	if (std::find(orderedLayers.begin(), orderedLayers.end(), layer) == orderedLayers.end())
+	{
+		orderedLayers.push_back(layer);
+	}
+}
+
+
+/**
+\brief		Sorts the commands by layer and surface and prepares their sprites to be drawn.
+\details	Each command is given the sequence of the first command in its layer drawing the same surface,
+			so sorting by layer, then by that sequence, then by its own sequence groups each surface
+			without depending on where the surfaces are in memory. The commands of a layer passed to
+			KeepOrder are given their own sequence, so they stay in the order they were submitted.
+			The frames prepared for the last frame are unpinned first, then every rotated frame this
+			frame needs is prepared and pinned, so the commands can be drawn from several threads
+			without anything being built or freed while they are drawn.
+*/
+void RenderQueue::Sort(void)
+{
+	batches.clear();
+	for (unsigned int i = 0; i < commands.size(); i++)
+	{
+		if (std::find(orderedLayers.begin(), orderedLayers.end(), commands[i].layer) != orderedLayers.end())
+		{
+			commands[i].batch = commands[i].sequence;
+			continue;
+		}
+		std::pair<int, const PixelSurface*> key(commands[i].layer, commands[i].surface);
+		std::map<std::pair<int, const PixelSurface*>, int>::iterator first = batches.find(key);
+		if (first == batches.end())
+		{
+			first = batches.insert(std::make_pair(key, commands[i].sequence)).first;
+		}
+		commands[i].batch = first->second;
+	}
+	std::sort(commands.begin(), commands.end(), Precedes);
+
+	for (unsigned int i = 0; i < commands.size(); i++)
+	{
+		if (commands[i].sprite != NULL)
+		{
+			commands[i].sprite->Unpin();
+		}
+	}
+
+	batchCount = 0;
+	for (unsigned int i = 0; i < commands.size(); i++)
+	{
+		if (i == 0 || commands[i].surface != commands[i - 1].surface || commands[i].blendMode != commands[i - 1].blendMode)
+		{
+			batchCount++;
+		}
+		if (commands[i].sprite != NULL)
+		{
+			commands[i].sprite->Prepare(commands[i].rotation);
+		}
+	}
+}
+
+
+/**
+\brief		Adds every command to the draw list of the passed compositor, in sorted order.
+\details	The compositor draws the commands through Draw, so the queue must not change until it has.
+\param[in]	compositor The compositor to draw the commands with.
+*/
+void RenderQueue::Dispatch(TileCompositor* compositor)
+{
+	for (unsigned int i = 0; i < commands.size(); i++)
+	{
+		compositor->Add(GetBounds(i), std::bind(&RenderQueue::Draw, this, std::placeholders::_1, (int)i));
+	}
+}
+
+
+/**
+\brief		Draws every command onto the passed surface on the calling thread, in sorted order.
+\details	Drawing the same queue again redraws the same frame, which is useful for profiling.
+\param[in]	target The surface to draw onto, limited to its clip rectangle.
+*/
+void RenderQueue::Execute(PixelSurface* target)
+{
+	for (unsigned int i = 0; i < commands.size(); i++)
+	{
+		Draw(target, i);
+	}
+}
+
+
+/**
+\brief		Draws a single command onto the passed surface.
+\param[in]	target The surface to draw onto, limited to its clip rectangle.
+\param[in]	index The index of the command in sorted order.
+*/
+void RenderQueue::Draw(PixelSurface* target, int index)
+{
+	DrawCommand* command = &commands[index];
+	if (command->sprite != NULL)
+	{
+		command->sprite->DrawAt(target, command->x, command->y, command->rotation);
+	}
+	else
+	{
+		PixelSurface::SelectBlitter(command->blendMode, false, PixelSurface::SAMPLING_NEAREST)(target,
+			command->surface, command->x, command->y, 0, NULL);
+	}
+}
+
+
+/**
+\brief		Removes every command, ready for the next frame.
+*/
+void RenderQueue::Clear(void)
+{
+	commands.clear();
+	batchCount = 0;
+}
+
+
+/**
+\brief		Returns the number of commands in the queue.
+\return		The number of commands submitted since the queue was last cleared.
+*/
+int RenderQueue::CommandCount(void)
+{
+	return commands.size();
+}
+
+
+/**
+\brief		Returns the number of batches found by the last Sort.
+\return		The number of runs of consecutive commands drawing the same surface with the same blend mode.
+*/
+int RenderQueue::BatchCount(void)
+{
+	return batchCount;
+}
+
+
+/**
+\brief		Returns a command of the queue.
+\param[in]	index The index of the command, in sorted order once the queue is sorted.
+\return		A pointer to the command.
+*/
+const DrawCommand* RenderQueue::GetCommand(int index)
+{
+	return &commands[index];
+}
+
+
+/**
+\brief		Returns the area of the target a command draws over.
+\param[in]	index The index of the command.
+\return		The bounds of the drawn sprite or surface.
+*/
+PixelRect RenderQueue::GetBounds(int index)
+{
+	DrawCommand* command = &commands[index];
+	if (command->sprite != NULL)
+	{
+		return command->sprite->GetBoundsAt(command->x, command->y, command->rotation);
+	}
+	PixelRect bounds = { command->x, command->y, command->surface->GetWidth(), command->surface->GetHeight() };
+	return bounds;
+}
+
+
+/**
+\brief		Compares two commands by layer, then by the surface they draw, then by the order they were submitted.
+\param[in]	a The first command.
+\param[in]	b The second command.
+\return		True if the first command is drawn before the second.
+*/
+bool RenderQueue::Precedes(const DrawCommand& a, const DrawCommand& b)
+{
+	if (a.layer != b.layer)
+	{
+		return a.layer < b.layer;
+	}
+	if (a.batch != b.batch)
+	{
+		return a.batch < b.batch;
+	}
+	return a.sequence < b.sequence;
+}
\ No newline at end of file
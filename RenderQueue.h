@@ -0,0 +1,78 @@
+#include "PixelSurface.h"
+#include "BitmapImage.h"
+#include "CompositeImage.h"
+#include "TileCompositor.h"
+#include <vector>
+#include <map>
+using namespace std;
+
+
+#ifndef __RENDER_QUEUE_H__
+#define __RENDER_QUEUE_H__
+
+
+// a sprite to draw, with everything needed to draw it after the sprite has moved on
+struct DrawCommand
+{
+	BitmapImage* sprite;				// the sprite to draw, or NULL to blit the surface directly
+	const PixelSurface* surface;		// the pixels drawn, the surface of the sprite if there is one
+	int x;								// the X coordinate of the unrotated sprite
+	int y;								// the Y coordinate of the unrotated sprite
+	int rotation;						// the rotation of the sprite in degrees
+	int layer;							// the layer the sprite is drawn in, lower layers are drawn first
+	PixelSurface::BlendMode blendMode;	// how the sprite is combined with the pixels underneath
+	int batch;							// the order of the first command of the layer drawing the same surface
+	int sequence;						// the order the command was submitted in
+};
+
+
+/**
+\class		RenderQueue
+\author		Tom Bisch
+\date		May 30, 2016
+\brief		A retained list of the commands that draw a frame, sorted by layer and surface before drawing.
+\details	Game objects submit a command for each sprite they draw, capturing its position, rotation,
+			layer and blend mode, so the sprites can be moved for the next frame while this one is drawn
+			and the same frame can be drawn again to profile it. Sort orders the commands by layer, and
+			within a layer groups the commands drawing the same surface, in the order each surface was
+			first submitted, so consecutive commands form batches reading the same pixels. Sprites of the
+			same layer drawn from different surfaces must not overlap unless they are submitted in that
+			order, or the layer is passed to KeepOrder to draw it in the order it was submitted. The
+			commands refer to the surfaces of the sprites, so they must be drawn before the sprites are
+			resized.
+*/
+class RenderQueue
+{
+
+private:
+	std::vector<DrawCommand> commands;	// the commands of the frame, sorted once Sort is called
+	std::map<std::pair<int, const PixelSurface*>, int> batches;	// the first command of each surface in each layer
+	int batchCount;						// the number of runs of commands sharing a surface and blend mode
+	std::vector<int> orderedLayers;		// the layers drawn in the order their commands were submitted
+
+	static bool Precedes(const DrawCommand& a, const DrawCommand& b);
+
+public:
+	RenderQueue(void);
+	~RenderQueue(void);
+
+	void Submit(BitmapImage* sprite, int layer);
+	void Submit(BitmapImage* sprite, int x, int y, int degrees, int layer);
+	void Submit(CompositeImage* image, int layer);
+	void SubmitSurface(const PixelSurface* surface, int x, int y, int layer, PixelSurface::BlendMode mode);
+	void KeepOrder(int layer);
+	void Sort(void);
+	void Dispatch(TileCompositor* compositor);
+	void Execute(PixelSurface* target);
+	void Draw(PixelSurface* target, int index);
+	void Clear(void);
+
+	int CommandCount(void);
+	int BatchCount(void);
+	const DrawCommand* GetCommand(int index);
+	PixelRect GetBounds(int index);
+
+};
+
+
+#endif
\ No newline at end of file
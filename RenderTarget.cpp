@@ -0,0 +1,178 @@
+#include "RenderTarget.h"
+
+
+/**
+\brief		Constructs a RenderTarget object for the passed window without a back buffer.
+\details	Resize must be called to create the back buffer before the first frame is drawn.
+\param[in]	window The handle to the window presented to.
+*/
+RenderTarget::RenderTarget(HWND window)
+{
+	hWnd = window;
+	hdcWindow = NULL;
+	hdcMem = NULL;
+	hBitmap = NULL;
+	hOldBitmap = NULL;
+	graphics = nullptr;
+}
+
+
+/**
+\brief		Destructor for a RenderTarget. Frees the back buffer and its GDI objects.
+*/
+RenderTarget::~RenderTarget(void)
+{
+	Release();
+}
+
+
+/**
+\brief		Recreates the back buffer and memory DC with the passed size.
+\details	Nothing is recreated if the size did not change. The pixels of the new back buffer are
+			all 0, so the whole window needs to be redrawn after a resize.
+\param[in]	width The new width of the back buffer.
+\param[in]	height The new height of the back buffer.
+\return		True if the back buffer was created, false if it could not be.
+*/
+bool RenderTarget::Resize(int width, int height)
+{
+	if (hBitmap != NULL && width == surface.GetWidth() && height == surface.GetHeight())
+	{
+		return true;
+	}
+	Release();
+	if (width <= 0 || height <= 0)
+	{
+		return false;
+	}
+
+	// top-down 32 bit DIB section, which has the same layout as a PixelSurface
+	BITMAPINFO info;
+	ZeroMemory(&info, sizeof(BITMAPINFO));
+	info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+	info.bmiHeader.biWidth = width;
+	info.bmiHeader.biHeight = -height;
+	info.bmiHeader.biPlanes = 1;
+	info.bmiHeader.biBitCount = 32;
+	info.bmiHeader.biCompression = BI_RGB;
+
+	HDC hdc = GetDC(hWnd);
+	void* bits = NULL;
+	hdcMem = CreateCompatibleDC(hdc);
+	hBitmap = CreateDIBSection(hdc, &info, DIB_RGB_COLORS, &bits, NULL, 0);
+	ReleaseDC(hWnd, hdc);
+	if (hdcMem == NULL || hBitmap == NULL)
+	{
+		Release();
+		return false;
+	}
+	hOldBitmap = SelectObject(hdcMem, hBitmap);
+	surface.Attach((unsigned int*)bits, width, height, width);
+	graphics = new Gdiplus::Graphics(hdcMem);
+	return true;
+}
+
+
+/**
+\brief		Frees the back buffer, the memory DC and the graphics object.
+*/
+void RenderTarget::Release(void)
+{
+	EndFrame();
+	surface.Release();
+	delete graphics;
+	graphics = nullptr;
+	if (hdcMem != NULL)
+	{
+		SelectObject(hdcMem, hOldBitmap);
+		DeleteDC(hdcMem);
+		hdcMem = NULL;
+	}
+	if (hBitmap != NULL)
+	{
+		DeleteObject(hBitmap);
+		hBitmap = NULL;
+	}
+	hOldBitmap = NULL;
+}
+
+
+/**
+\brief		Starts drawing a frame by getting the DC of the window.
+\details	GDI is flushed first so text drawn with the graphics object in the last frame is in the
+			back buffer before its pixels are written directly.
+\return		A pointer to the back buffer to draw the frame onto, which is empty if it could not be created.
+*/
+PixelSurface* RenderTarget::BeginFrame(void)
+{
+	GdiFlush();
+	hdcWindow = GetDC(hWnd);
+	return &surface;
+}
+
+
+/**
+\brief		Copies a rectangle of the back buffer to the same position on the window.
+\details	Must be called between BeginFrame and EndFrame.
+\param[in]	rect The rectangle to copy.
+*/
+void RenderTarget::Present(const PixelRect* rect)
+{
+	if (hdcWindow == NULL || hdcMem == NULL)
+	{
+		return;
+	}
+	GdiFlush();
+	BitBlt(hdcWindow, rect->x, rect->y, rect->width, rect->height, hdcMem, rect->x, rect->y, SRCCOPY);
+}
+
+
+/**
+\brief		Finishes drawing a frame by releasing the DC of the window.
+*/
+void RenderTarget::EndFrame(void)
+{
+	if (hdcWindow != NULL)
+	{
+		ReleaseDC(hWnd, hdcWindow);
+		hdcWindow = NULL;
+	}
+}
+
+
+/**
+\brief		Repaints the invalid part of the window from the back buffer in response to WM_PAINT.
+\details	The back buffer still holds the last frame, so nothing needs to be redrawn.
+*/
+void RenderTarget::Paint(void)
+{
+	PAINTSTRUCT ps;
+	HDC hdc = BeginPaint(hWnd, &ps);
+	if (hdcMem != NULL)
+	{
+		BitBlt(hdc, ps.rcPaint.left, ps.rcPaint.top, ps.rcPaint.right - ps.rcPaint.left, 
+			ps.rcPaint.bottom - ps.rcPaint.top, hdcMem, ps.rcPaint.left, ps.rcPaint.top, SRCCOPY);
+	}
+	EndPaint(hWnd, &ps);
+}
+
+
+/**
+\brief		Returns the back buffer.
+\return		A pointer to the back buffer.
+*/
+PixelSurface* RenderTarget::GetSurface(void)
+{
+	return &surface;
+}
+
+
+/**
+\brief		Returns the graphics object that draws onto the back buffer.
+\details	Anything drawn with it is only shown once the rectangle it was drawn in is presented.
+\return		A pointer to the graphics object, which is NULL if there is no back buffer.
+*/
+Gdiplus::Graphics* RenderTarget::GetGraphics(void)
+{
+	return graphics;
+}
\ No newline at end of file
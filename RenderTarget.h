@@ -0,0 +1,52 @@
+#include "PixelSurface.h"
+#include <windows.h>
+#include <gdiplus.h>
+using namespace Gdiplus;
+using namespace std;
+
+
+#ifndef __RENDER_TARGET_H__
+#define __RENDER_TARGET_H__
+
+
+/**
+\class		RenderTarget
+\author		Tom Bisch
+\date		May 6, 2016
+\brief		Owns the back buffer of a window and the GDI objects used to present it.
+\details	The back buffer is a DIB section selected into a memory DC, and its pixels are wrapped by a 
+			PixelSurface so the game objects are drawn straight into the bitmap GDI presents from. The 
+			DC, the bitmap and the Gdiplus::Graphics object drawing onto it live as long as the window
+			and are only recreated when the window is resized. Each frame is drawn between BeginFrame 
+			and EndFrame, which get and release the DC of the window.
+*/
+class RenderTarget
+{
+
+private:
+	HWND hWnd;							// the window presented to
+	HDC hdcWindow;						// the DC of the window, only valid between BeginFrame and EndFrame
+	HDC hdcMem;							// the memory DC the back buffer is selected into
+	HBITMAP hBitmap;					// the DIB section holding the back buffer
+	HGDIOBJ hOldBitmap;					// the bitmap selected into the memory DC when it was created
+	Gdiplus::Graphics* graphics;		// draws onto the memory DC
+	PixelSurface surface;				// wraps the pixels of the DIB section
+
+	void Release(void);
+
+public:
+	RenderTarget(HWND window);
+	~RenderTarget(void);
+
+	bool Resize(int width, int height);
+	PixelSurface* BeginFrame(void);
+	void Present(const PixelRect* rect);
+	void EndFrame(void);
+	void Paint(void);
+	PixelSurface* GetSurface(void);
+	Gdiplus::Graphics* GetGraphics(void);
+
+};
+
+
+#endif
\ No newline at end of file
@@ -1,5 +1,4 @@
 #include "Reptile.h"
-#include "Scoreboard.h"
 
 
 // class constants
@@ -12,18 +11,34 @@ const int Reptile::FLYSTATE_UP = 0;
 const int Reptile::FLYSTATE_DOWN = 1;
 const int Reptile::FLYTIME_MAX = 40;
 const int Reptile::FLYTIME_MIN = 20;
+const int Reptile::FLAP_LENGTH;
+const Reptile::Frame Reptile::FLAP_SEQUENCE[Reptile::FLAP_LENGTH] = 
+{
+	FRAME_FLAP0, FRAME_FLAP1, FRAME_FLAP2, FRAME_FLAP3, FRAME_FLAP4, 
+	FRAME_FLAP5, FRAME_FLAP4, FRAME_FLAP3, FRAME_FLAP2, FRAME_FLAP1
+};
 
 
 /**
 \brief		Constructs a Reptile object and sets default values for members.
+\param[in]	randomSeed The seed for the random numbers that drive the reptile's flight path.
 */
-Reptile::Reptile(void) : CompositeImage()
+Reptile::Reptile(unsigned int randomSeed)
 {
+	seed = randomSeed;
+	xPos = 0;
+	yPos = 0;
+	xPrevPos = 0;
+	yPrevPos = 0;
+	width = 0;
+	height = 0;
+	rotation = 0;
 	xVel = 8;
 	yVel = 0;
 	state = STATE_FLYING;
+	flyState = FLYSTATE_DOWN;
 	resetTimeCount = 0;
-	flyTime = rand() % (FLYTIME_MAX - FLYTIME_MIN + 1) + FLYTIME_MIN;
+	flyTime = Random() % (FLYTIME_MAX - FLYTIME_MIN + 1) + FLYTIME_MIN;
 	flyTimeCount = 0;
 	imageIndex = 0;
 	isHit = false;
@@ -42,18 +57,20 @@ Reptile::~Reptile(void)
 \brief		Checks for a boundary collision with the Reptile object.
 \details	The point created from the passed X and Y coordinates is compared to the 
 			boundaries of the Reptile bitmap to determine if the point is in contact 
-			with the Reptile object.
+			with the Reptile object. If a hit mask is passed, the point must also land on 
+			a solid pixel of the bitmap, so the transparent corners of the bitmap are missed.
 \param[in]	x The X coordinate combined with the Y coordinate to form a point.
 \param[in]	y The Y coordinate combined with the X coordinate to form a point.
+\param[in]	mask The solid pixels of the unrotated bitmap drawn at the reptile's position, or NULL.
 */
-bool Reptile::CheckCollision(int x, int y)
+bool Reptile::CheckCollision(int x, int y, const HitMask* mask)
 {	
 	if (x > GetXPos() &&
 		x < (GetXPos() + GetWidth()) &&
 		y > GetYPos() &&
 		y < (GetYPos() + GetHeight()))
 	{
-		return true;
+		return mask == NULL || mask->Contains(x - GetXPos(), y - GetYPos()) == true;
 	}
 	else
 	{
@@ -83,28 +100,18 @@ int Reptile::GetState(void)
 
 
 /**
-\brief		Returns the name of the bitmap to draw for the reptile.
-\return		The name of the BitmapImage whose bitmap should be drawn to represent the Reptile.
+\brief		Returns the image/frame to draw for the reptile.
+\details	While flying, the frame is looked up in the FLAP_SEQUENCE table, otherwise the reptile
+			is drawn dead.
+\return		The frame whose bitmap should be drawn to represent the Reptile.
 */
-wstring Reptile::GetNameOfImageToDraw(void)
+Reptile::Frame Reptile::GetFrameToDraw(void)
 {
-	wstring imageName;
-	switch (imageIndex)
+	if (imageIndex >= 0 && imageIndex < FLAP_LENGTH)
 	{
-		case 0: imageName = L"flap0"; break;
-		case 1: imageName = L"flap1"; break;
-		case 2: imageName = L"flap2"; break;
-		case 3: imageName = L"flap3"; break;
-		case 4: imageName = L"flap4"; break;
-		case 5: imageName = L"flap5"; break;
-		case 6: imageName = L"flap4"; break;
-		case 7: imageName = L"flap3"; break;
-		case 8: imageName = L"flap2"; break;
-		case 9: imageName = L"flap1"; break;
-		case 10: imageName = L"dead"; break;
-		default: imageName = L"flap0"; break;
+		return FLAP_SEQUENCE[imageIndex];
 	}
-	return imageName;
+	return FRAME_DEAD;
 }
 
 
@@ -134,7 +141,7 @@ bool Reptile::Update(int windowWidth, int windowHeight)
 		imageIndex++;
 
 		// reset to first image\frame of sequence
-		if (imageIndex >= 10)
+		if (imageIndex >= FLAP_LENGTH)
 		{
 			imageIndex = 0;
 		}
@@ -144,7 +151,7 @@ bool Reptile::Update(int windowWidth, int windowHeight)
 		{
 			// calculate random vertical velocity between 1 - 5,
 			// then take the negative of that number
-			yVel = (float)-(rand() % 5 + 1);
+			yVel = (float)-(Random() % 5 + 1);
 			// check if going to high
 			if (GetYPos() < 0)
 			{
@@ -155,7 +162,7 @@ bool Reptile::Update(int windowWidth, int windowHeight)
 		else
 		{
 			// calculate random vertical velocity between 1 - 5
-			yVel = (float)(rand() % 5 + 1);
+			yVel = (float)(Random() % 5 + 1);
 			// check if going to low
 			if (GetYPos() > windowHeight * 0.35)
 			{
@@ -173,19 +180,19 @@ bool Reptile::Update(int windowWidth, int windowHeight)
 		if (flyTimeCount >= flyTime)
 		{
 			// calculate random time to fly in a direction
-			flyTime = rand() % (FLYTIME_MAX - FLYTIME_MIN + 1) + FLYTIME_MIN;
+			flyTime = Random() % (FLYTIME_MAX - FLYTIME_MIN + 1) + FLYTIME_MIN;
 			flyTimeCount = 0;
 
 			// calculate random horizontal velocity between 5 - 8
-			xVel = (float)(rand() % 4 + 5);
+			xVel = (float)(Random() % 4 + 5);
 
 			// randomly invert X and Y velocity
- 			if (rand() % 2 == 0)
+ 			if (Random() % 2 == 0)
 			{
 				// invert horizontal velocity
 				xVel *= -1;
 			}
-			if (rand() % 2 == 0)
+			if (Random() % 2 == 0)
 			{
 				// invert vertical velocity
 				flyState = !flyState;
@@ -196,8 +203,8 @@ bool Reptile::Update(int windowWidth, int windowHeight)
 	// reptile falling
 	else if (state == STATE_FALLING)
 	{
-		// set reptile image/frame to dead image
-		imageIndex = 10;
+		// set reptile image/frame to dead image, which is past the end of the flap sequence
+		imageIndex = FLAP_LENGTH;
 
 		// update X velocity and rotation
 		if (xVel > 0)
@@ -231,7 +238,7 @@ bool Reptile::Update(int windowWidth, int windowHeight)
 	}
 
 	// reptile grounded
-	else if (state = STATE_GROUNDED)
+	else if (state == STATE_GROUNDED)
 	{
 		// update X velocity and rotation
 		if (xVel > 0)
@@ -393,11 +400,9 @@ void Reptile::SetYPrevPos(int yPrevPos)
 */
 void Reptile::Reset(int windowWidth, int windowHeight)
 {
-	// update scoreboard for next round
-	Scoreboard::StartNextRound();
 	// calculate random X velocity
-	xVel = (float)(rand() % 4 + 5);
-	if (rand() % 2 == 0)
+	xVel = (float)(Random() % 4 + 5);
+	if (Random() % 2 == 0)
 	{
 		// invert horizontal velocity
 		xVel *= -1;
@@ -407,7 +412,108 @@ void Reptile::Reset(int windowWidth, int windowHeight)
 	resetTimeCount = 0;
 	Rotate(0);
 	// start reptile at random X postion at top of window
-	MoveTo((int)(windowWidth * (rand() % 9) * 0.1), 0);
+	MoveTo((int)(windowWidth * (Random() % 9) * 0.1), 0);
 	imageIndex = 0;
 	isHit = false;
+}
+
+
+/**
+\brief		Returns the next pseudo-random number for the Reptile object.
+\details	Uses the same linear congruential generator as the C runtime rand() function, but keeps
+			the state in the Reptile so that a run can be reproduced from its seed and several 
+			simulations can run side by side without sharing random state.
+\return		A pseudo-random number from 0 to 32767.
+*/
+int Reptile::Random(void)
+{
+	seed = seed * 214013 + 2531011;
+	return (seed >> 16) & 0x7fff;
+}
+
+
+/**
+\brief		Translates the Reptile object to the passed X and Y coordinates.
+\param[in]	x The new X coordinate of the reptile.
+\param[in]	y The new Y coordinate of the reptile.
+*/
+void Reptile::MoveTo(int x, int y)
+{
+	xPos = x;
+	yPos = y;
+}
+
+
+/**
+\brief		Sets the rotation of the Reptile object to the passed parameter value.
+\details	Uses the mod operator to truncate the parameter value because degrees range from 0 - 360.
+\param[in]	degrees The new rotation of the reptile.
+*/
+void Reptile::Rotate(int degrees)
+{
+	rotation = degrees % 360;
+}
+
+
+/**
+\brief		Sets the width and height of the Reptile object used for collision checks.
+\details	Called whenever the bitmaps representing the reptile are resized so that the 
+			reptile occupies the same area in the game as it does on the window.
+\param[in]	width The new width of the reptile.
+\param[in]	height The new height of the reptile.
+*/
+void Reptile::SetSize(int width, int height)
+{
+	Reptile::width = width;
+	Reptile::height = height;
+}
+
+
+/**
+\brief		Returns the X coordinate of the Reptile object.
+\return		The X coordinate of the reptile.
+*/
+int Reptile::GetXPos(void)
+{
+	return xPos;
+}
+
+
+/**
+\brief		Returns the Y coordinate of the Reptile object.
+\return		The Y coordinate of the reptile.
+*/
+int Reptile::GetYPos(void)
+{
+	return yPos;
+}
+
+
+/**
+\brief		Returns the width of the Reptile object.
+\return		The width of the reptile.
+*/
+int Reptile::GetWidth(void)
+{
+	return width;
+}
+
+
+/**
+\brief		Returns the height of the Reptile object.
+\return		The height of the reptile.
+*/
+int Reptile::GetHeight(void)
+{
+	return height;
+}
+
+
+/**
+\brief		Returns the rotation of the Reptile object.
+\return		The rotation of the reptile.
+*/
+int Reptile::GetRotation(void)
+{
+	return rotation;
 }
\ No newline at end of file
@@ -1,8 +1,5 @@
-#include "CompositeImage.h"
-#include <windows.h>
-#include <gdiplus.h>
+#include "HitMask.h"
 #include <string>
-using namespace Gdiplus;
 using namespace std;
 
 
@@ -15,28 +12,52 @@ using namespace std;
 \author		Tom Bisch
 \date		Mar 1, 2016
 \brief		Represents and keeps track of a flying reptile object.
-\details	Contains methods for checking for boundary collisions, updating the position on the screen, 
-			getting and setting the state, getting the name of the current bitmap representing the reptile, 
+\details	Contains methods for checking for boundary collisions, updating the position on the screen,
+			getting and setting the state, getting the name of the current bitmap representing the reptile,
 			resetting the reptile to an initial starting state and getting and setting various attributes.
-			Inherits from the CompositeImage class.
+			The Reptile only tracks its position, size and rotation; the bitmaps representing it are kept
+			in a separate CompositeImage so the reptile can be simulated without a window.
 */
-class Reptile : public CompositeImage
+class Reptile
 {
 
 private:
+	int xPos;							// X coordinate of the reptile
+	int yPos;							// Y coordinate of the reptile
 	int xPrevPos;						// X coordinate of previous reptile position
 	int yPrevPos;						// Y coordinate of previous reptile position
+	int width;							// the width of the reptile
+	int height;							// the height of the reptile
+	int rotation;						// the rotation of the reptile
 	float xVel;							// the X velocity of the reptile
-	float yVel;							// the Y velocity of the reptile	
+	float yVel;							// the Y velocity of the reptile
 	int state;							// reptiles current state
 	int flyState;						// reptiles current flying state
 	int resetTimeCount;					// counts up to RESET_TIME
 	int flyTime;						// time until reptile changes flight direction
 	int flyTimeCount;					// counts up to flyTime
-	int imageIndex;						// the current image/frame of the reptile
+	int imageIndex;						// the position of the reptile in its flap sequence
 	bool isHit;							// indicates if reptile has been hit this frame
+	unsigned int seed;					// state of the reptile's random number generator
+
+	int Random(void);
 
 public:
+	// the images/frames the reptile is drawn with
+	enum Frame
+	{
+		FRAME_FLAP0,
+		FRAME_FLAP1,
+		FRAME_FLAP2,
+		FRAME_FLAP3,
+		FRAME_FLAP4,
+		FRAME_FLAP5,
+		FRAME_DEAD,
+		FRAME_COUNT
+	};
+
+	static const int FLAP_LENGTH = 10;	// number of frames in one flap of the wings
+	static const Frame FLAP_SEQUENCE[FLAP_LENGTH];	// frames of one flap, wings down then back up
 	static const float FRICTION;		// force of friction on reptile
 	static const int RESET_TIME;		// time before reptile resets after hitting ground
 	static const int STATE_FLYING;		// reptile is flying
@@ -47,15 +68,15 @@ public:
 	static const int FLYTIME_MAX;		// fly interval max time
 	static const int FLYTIME_MIN;		// fly interval min time
 
-	Reptile(void);
+	Reptile(unsigned int randomSeed = 1);
 	~Reptile(void);
 
-	bool CheckCollision(int x, int y);
+	bool CheckCollision(int x, int y, const HitMask* mask = NULL);
 	bool Update(int windowWidth, int windowHeight);
 	void SetState(int newState);
 	int GetState(void);
-	wstring GetNameOfImageToDraw(void);
-	void Reptile::SetIsHit(bool isHit);
+	Frame GetFrameToDraw(void);
+	void SetIsHit(bool isHit);
 	bool GetIsHit(void);
 	float GetXVel(void);
 	float GetYVel(void);
@@ -67,6 +88,15 @@ public:
 	void SetYPrevPos(int yPrevPos);
 	void Reset(int windowWidth, int windowHeight);
 
+	void MoveTo(int x, int y);
+	void Rotate(int degrees);
+	void SetSize(int width, int height);
+	int GetXPos(void);
+	int GetYPos(void);
+	int GetWidth(void);
+	int GetHeight(void);
+	int GetRotation(void);
+
 };
 
 
@@ -0,0 +1,392 @@
+#include "ReptileFlock.h"
+
+
+/**
+\brief		Constructs an empty ReptileFlock object.
+*/
+ReptileFlock::ReptileFlock(void)
+{
+	width = 0;
+	height = 0;
+}
+
+
+/**
+\brief		Destructor for a ReptileFlock. Currently does nothing.
+*/
+ReptileFlock::~ReptileFlock(void)
+{
+}
+
+
+/**
+\brief		Adds a reptile in the same starting state as a newly constructed Reptile.
+\param[in]	randomSeed The seed for the random numbers that drive the reptile's flight path.
+\return		The index of the new reptile.
+*/
+int ReptileFlock::Add(unsigned int randomSeed)
+{
+	int index = Count();
+	xPos.push_back(0);
+	yPos.push_back(0);
+	rotation.push_back(0);
+	xVel.push_back(8);
+	yVel.push_back(0);
+	state.push_back(Reptile::STATE_FLYING);
+	flyState.push_back(Reptile::FLYSTATE_DOWN);
+	resetTimeCount.push_back(0);
+	flyTime.push_back(0);
+	flyTimeCount.push_back(0);
+	imageIndex.push_back(0);
+	seeds.push_back(randomSeed);
+	flyTime[index] = Random(index) % (Reptile::FLYTIME_MAX - Reptile::FLYTIME_MIN + 1) + Reptile::FLYTIME_MIN;
+	return index;
+}
+
+
+/**
+\brief		Adds the passed number of reptiles, each reset to a random position along the top of the window.
+\details	Each reptile is seeded from the passed seed and its position in the flock, so the same
+			seed always spawns the same flock.
+\param[in]	count The number of reptiles to add.
+\param[in]	randomSeed The seed the seeds of the reptiles are made from.
+\param[in]	windowWidth The width of the window to fly the reptiles in.
+\param[in]	windowHeight The height of the window to fly the reptiles in.
+*/
+void ReptileFlock::Spawn(int count, unsigned int randomSeed, int windowWidth, int windowHeight)
+{
+	for (int i = 0; i < count; i++)
+	{
+		int index = Add(randomSeed + (unsigned int)Count() * 2654435761u);
+		Reset(index, windowWidth, windowHeight);
+	}
+}
+
+
+/**
+\brief		Removes every reptile from the flock.
+*/
+void ReptileFlock::Clear(void)
+{
+	xPos.clear();
+	yPos.clear();
+	rotation.clear();
+	xVel.clear();
+	yVel.clear();
+	state.clear();
+	flyState.clear();
+	resetTimeCount.clear();
+	flyTime.clear();
+	flyTimeCount.clear();
+	imageIndex.clear();
+	seeds.clear();
+}
+
+
+/**
+\brief		Updates the position of every reptile for the next frame, the same as Reptile::Update.
+\details	The first loop works out the flying, falling and grounded results of every reptile and keeps
+			those of the state it is in, so no reptile branches on its state. A flying reptile draws
+			one random number every frame, which is computed for every reptile and only kept by those
+			flying. The second loop changes the direction of the flying reptiles whose fly time is up
+			and resets the reptiles that have been on the ground long enough, which draw a varying
+			number of random numbers. The last loop bounces the reptiles off the sides of the window
+			and keeps them above the ground, after any resets just like Reptile::Update.
+\param[in]	windowWidth The width of the window to fly the reptiles in.
+\param[in]	windowHeight The height of the window to fly the reptiles in.
+\return		The number of reptiles that were reset.
+*/
+int ReptileFlock::Update(int windowWidth, int windowHeight)
+{
+	int count = Count();
+	int highest = (int)(windowHeight * 0.35);	// flying reptiles below this turn back up
+	int ground = (int)(windowHeight * 0.82);	// falling reptiles below this are grounded
+	// the constants are defined in Reptile.cpp, so they are copied here where the compiler can see they never change
+	int flying = Reptile::STATE_FLYING;
+	int falling = Reptile::STATE_FALLING;
+	int grounded = Reptile::STATE_GROUNDED;
+	int up = Reptile::FLYSTATE_UP;
+	float friction = Reptile::FRICTION;
+	int resetCount = 0;
+
+	// the arrays are read through plain pointers so the loops below do not go through the vectors
+	int* x = xPos.data();
+	int* y = yPos.data();
+	int* angle = rotation.data();
+	float* xv = xVel.data();
+	int* yv = yVel.data();
+	int* st = state.data();
+	int* fly = flyState.data();
+	int* groundTime = resetTimeCount.data();
+	int* flyCount = flyTimeCount.data();
+	int* image = imageIndex.data();
+	unsigned int* seed = seeds.data();
+
+	// flying, falling and grounded, over more arrays than the compiler checks for overlaps on its own
+#if defined(_MSC_VER)
+#pragma loop(ivdep)
+#elif defined(__GNUC__)
+#pragma GCC ivdep
+#endif
+	for (int i = 0; i < count; i++)
+	{
+		int isFlying = st[i] == flying;
+		int isFalling = st[i] == falling;
+		int isGrounded = st[i] == grounded;
+
+		// flying: flap, fly up or down at a random speed from 1 - 5 and turn at the top or bottom of the flight area
+		int flap = (image[i] + 1) * (image[i] + 1 < Reptile::FLAP_LENGTH);
+		unsigned int nextSeed = seed[i] * 214013 + 2531011;
+		int speed = (int)((nextSeed >> 16) & 0x7fff) % 5 + 1;
+		int isUp = fly[i] == up;
+		int turns = (isUp & (y[i] < 0)) | (!isUp & (y[i] > highest));
+
+		// falling and grounded: slow down by friction, unless that would stop or turn the reptile, and spin;
+		// moving towards zero by friction only when the speed is above it is the same as the checks in
+		// Reptile::Update, and leaves no float math inside a branch the compiler would have to keep
+		float v = xv[i];
+		int slowing = ((v > friction) - (v < -friction)) * !isFlying;
+		float slowed = v - friction * slowing;
+		int fallingRotation = (angle[i] + (v > 0) * 10 - 5) % 360;
+		int groundedRotation = (angle[i] + (int)slowed) % 360;
+
+		// keep the results of the state the reptile is in, each written as the old value plus the change
+		// for the states that make it, so every store is done for every reptile and there is no branch
+		seed[i] += isFlying * (nextSeed - seed[i]);
+		image[i] += isFlying * (flap - image[i]) + isFalling * (Reptile::FLAP_LENGTH - image[i]);
+		fly[i] += (isFlying & turns) * (!fly[i] - fly[i]);
+		flyCount[i] += isFlying;
+		groundTime[i] += isGrounded;
+		xv[i] = slowed;
+		yv[i] += isFlying * (speed - 2 * speed * isUp - yv[i]) + isFalling * (5 - yv[i]);
+		angle[i] += isFalling * (fallingRotation - angle[i]) + isGrounded * (groundedRotation - angle[i]);
+		x[i] += (int)xv[i];
+		y[i] += yv[i];
+		st[i] += (isFalling & (y[i] > ground)) * (grounded - st[i]);
+	}
+
+	// the few reptiles changing direction or starting over
+	for (int i = 0; i < count; i++)
+	{
+		if (st[i] == Reptile::STATE_FLYING && flyCount[i] >= flyTime[i])
+		{
+			ChangeDirection(i);
+		}
+		else if (st[i] == Reptile::STATE_GROUNDED && groundTime[i] >= Reptile::RESET_TIME)
+		{
+			Reset(i, windowWidth, windowHeight);
+			resetCount++;
+		}
+	}
+
+	// bounce off the sides of the window, a reptile past both sides bounces twice, and stay above the ground
+	for (int i = 0; i < count; i++)
+	{
+		int bounces = (x[i] + width > windowWidth) + (x[i] < 0);
+		xv[i] = bounces == 1 ? -xv[i] : xv[i];
+		y[i] = y[i] > ground ? ground : y[i];
+	}
+
+	return resetCount;
+}
+
+
+/**
+\brief		Takes a shot at the passed X and Y coordinates.
+\details	The reptiles are checked from the last to the first, and the first flying reptile the point is
+			inside of starts falling. That is the order they are drawn in from the top as long as they are
+			drawn in index order, which Main.cpp keeps with RenderQueue::KeepOrder. With hit masks, the point
+			must land on a solid pixel of the frame the reptile is drawn with, the same as Reptile::CheckCollision.
+\param[in]	x The X coordinate of the shot.
+\param[in]	y The Y coordinate of the shot.
+\param[in]	frameMasks The hit mask of each frame, indexed by Reptile::Frame, or NULL to test the bounds only.
+\return		The index of the reptile that was hit, or -1 if no flying reptile was hit.
+*/
+int ReptileFlock::Shoot(int x, int y, const HitMask* const* frameMasks)
+{
+	for (int i = Count() - 1; i >= 0; i--)
+	{
+		if (state[i] == Reptile::STATE_FLYING && x > xPos[i] && x < xPos[i] + width && y > yPos[i] && y < yPos[i] + height &&
+			(frameMasks == NULL || frameMasks[GetFrameToDraw(i)] == NULL ||
+			frameMasks[GetFrameToDraw(i)]->Contains(x - xPos[i], y - yPos[i]) == true))
+		{
+			state[i] = Reptile::STATE_FALLING;
+			return i;
+		}
+	}
+	return -1;
+}
+
+
+/**
+\brief		Sets the state of a reptile.
+\param[in]	index The index of the reptile.
+\param[in]	newState The new state of the reptile.
+*/
+void ReptileFlock::SetState(int index, int newState)
+{
+	state[index] = newState;
+}
+
+
+/**
+\brief		Sets the width and height of every reptile, used for bouncing off the window and for shots.
+\param[in]	reptileWidth The new width of the reptiles.
+\param[in]	reptileHeight The new height of the reptiles.
+*/
+void ReptileFlock::SetSize(int reptileWidth, int reptileHeight)
+{
+	width = reptileWidth;
+	height = reptileHeight;
+}
+
+
+/**
+\brief		Returns the number of reptiles in the flock.
+\return		The number of reptiles.
+*/
+int ReptileFlock::Count(void)
+{
+	return xPos.size();
+}
+
+
+/**
+\brief		Returns the X coordinate of a reptile.
+\param[in]	index The index of the reptile.
+\return		The X coordinate of the reptile.
+*/
+int ReptileFlock::GetXPos(int index)
+{
+	return xPos[index];
+}
+
+
+/**
+\brief		Returns the Y coordinate of a reptile.
+\param[in]	index The index of the reptile.
+\return		The Y coordinate of the reptile.
+*/
+int ReptileFlock::GetYPos(int index)
+{
+	return yPos[index];
+}
+
+
+/**
+\brief		Returns the rotation of a reptile.
+\param[in]	index The index of the reptile.
+\return		The rotation of the reptile.
+*/
+int ReptileFlock::GetRotation(int index)
+{
+	return rotation[index];
+}
+
+
+/**
+\brief		Returns the state of a reptile.
+\param[in]	index The index of the reptile.
+\return		The state of the reptile.
+*/
+int ReptileFlock::GetState(int index)
+{
+	return state[index];
+}
+
+
+/**
+\brief		Returns the image/frame to draw for a reptile, the same as Reptile::GetFrameToDraw.
+\param[in]	index The index of the reptile.
+\return		The frame whose bitmap should be drawn to represent the reptile.
+*/
+Reptile::Frame ReptileFlock::GetFrameToDraw(int index)
+{
+	if (imageIndex[index] >= 0 && imageIndex[index] < Reptile::FLAP_LENGTH)
+	{
+		return Reptile::FLAP_SEQUENCE[imageIndex[index]];
+	}
+	return Reptile::FRAME_DEAD;
+}
+
+
+/**
+\brief		Returns the width shared by every reptile.
+\return		The width of the reptiles.
+*/
+int ReptileFlock::GetWidth(void)
+{
+	return width;
+}
+
+
+/**
+\brief		Returns the height shared by every reptile.
+\return		The height of the reptiles.
+*/
+int ReptileFlock::GetHeight(void)
+{
+	return height;
+}
+
+
+/**
+\brief		Starts a flying reptile in a new random direction for a new random time.
+\param[in]	index The index of the reptile.
+*/
+void ReptileFlock::ChangeDirection(int index)
+{
+	// calculate random time to fly in a direction
+	flyTime[index] = Random(index) % (Reptile::FLYTIME_MAX - Reptile::FLYTIME_MIN + 1) + Reptile::FLYTIME_MIN;
+	flyTimeCount[index] = 0;
+
+	// calculate random horizontal velocity between 5 - 8
+	xVel[index] = (float)(Random(index) % 4 + 5);
+
+	// randomly invert X and Y velocity
+	if (Random(index) % 2 == 0)
+	{
+		xVel[index] *= -1;
+	}
+	if (Random(index) % 2 == 0)
+	{
+		flyState[index] = !flyState[index];
+	}
+}
+
+
+/**
+\brief		Starts a reptile flying again from the top of the window, the same as Reptile::Reset.
+\param[in]	index The index of the reptile.
+\param[in]	windowWidth The width of the window to fly the reptile in.
+\param[in]	windowHeight The height of the window to fly the reptile in.
+*/
+void ReptileFlock::Reset(int index, int windowWidth, int windowHeight)
+{
+	// calculate random X velocity
+	xVel[index] = (float)(Random(index) % 4 + 5);
+	if (Random(index) % 2 == 0)
+	{
+		xVel[index] *= -1;
+	}
+	yVel[index] = 0;
+	state[index] = Reptile::STATE_FLYING;
+	resetTimeCount[index] = 0;
+	rotation[index] = 0;
+	// start reptile at random X postion at top of window
+	xPos[index] = (int)(windowWidth * (Random(index) % 9) * 0.1);
+	yPos[index] = 0;
+	imageIndex[index] = 0;
+}
+
+
+/**
+\brief		Returns the next pseudo-random number of a reptile, from the same generator as Reptile.
+\param[in]	index The index of the reptile.
+\return		A pseudo-random number from 0 to 32767.
+*/
+int ReptileFlock::Random(int index)
+{
+	seeds[index] = seeds[index] * 214013 + 2531011;
+	return (seeds[index] >> 16) & 0x7fff;
+}
\ No newline at end of file
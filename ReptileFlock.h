@@ -0,0 +1,71 @@
+#include "Reptile.h"
+#include <vector>
+using namespace std;
+
+
+#ifndef __REPTILE_FLOCK_H__
+#define __REPTILE_FLOCK_H__
+
+
+/**
+\class		ReptileFlock
+\author		Tom Bisch
+\date		Jun 2, 2016
+\brief		Simulates a flock of reptiles that fly, fall and roll exactly like a Reptile, stored as arrays.
+\details	Each field of the reptiles is kept in an array of its own, indexed by reptile, instead of one
+			Reptile object per reptile. Update runs the flying, falling and grounded logic of Reptile::Update
+			for the whole flock in one branch-free loop over the arrays, adding the changes of each reptile's
+			state to its fields rather than branching on it, so the compiler can vectorize it. Only the
+			rare events, changing direction and resetting after a landing, are handled one reptile at a
+			time afterwards. Every reptile has its own random number generator, so a reptile of the flock
+			moves the same as a Reptile constructed with the same seed. All the reptiles are the same size
+			and share the same bitmaps, they only differ in position, rotation and frame.
+*/
+class ReptileFlock
+{
+
+private:
+	std::vector<int> xPos;				// the X coordinate of each reptile
+	std::vector<int> yPos;				// the Y coordinate of each reptile
+	std::vector<int> rotation;			// the rotation of each reptile
+	std::vector<float> xVel;			// the X velocity of each reptile
+	std::vector<int> yVel;				// the Y velocity of each reptile, always a whole number of pixels
+	std::vector<int> state;				// the state of each reptile
+	std::vector<int> flyState;			// the flying state of each reptile
+	std::vector<int> resetTimeCount;	// counts up to RESET_TIME for each grounded reptile
+	std::vector<int> flyTime;			// the time until each reptile changes flight direction
+	std::vector<int> flyTimeCount;		// counts up to flyTime for each reptile
+	std::vector<int> imageIndex;		// the position of each reptile in its flap sequence
+	std::vector<unsigned int> seeds;	// the state of each reptile's random number generator
+	int width;							// the width of every reptile
+	int height;							// the height of every reptile
+
+	void ChangeDirection(int index);
+	void Reset(int index, int windowWidth, int windowHeight);
+	int Random(int index);
+
+public:
+	ReptileFlock(void);
+	~ReptileFlock(void);
+
+	int Add(unsigned int randomSeed);
+	void Spawn(int count, unsigned int randomSeed, int windowWidth, int windowHeight);
+	void Clear(void);
+	int Update(int windowWidth, int windowHeight);
+	int Shoot(int x, int y, const HitMask* const* frameMasks = NULL);
+	void SetState(int index, int newState);
+	void SetSize(int reptileWidth, int reptileHeight);
+
+	int Count(void);
+	int GetXPos(int index);
+	int GetYPos(int index);
+	int GetRotation(int index);
+	int GetState(int index);
+	Reptile::Frame GetFrameToDraw(int index);
+	int GetWidth(void);
+	int GetHeight(void);
+
+};
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,556 @@
+#include "Resampler.h"
+#include <cmath>
+#include <cstring>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RESAMPLER_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define RESAMPLER_AVX2
+#include <immintrin.h>
+#endif
+
+
+// class constants
+const int Resampler::WEIGHT_BITS = 14;
+const int Resampler::ONE = 1 << Resampler::WEIGHT_BITS;
+
+
+// class members
+Resampler::InstructionSet Resampler::instructionSet = Resampler::GetWidestInstructionSet();
+
+
+/**
+\brief		Replaces the pixels of the destination surface with the source surface scaled to the passed size.
+\details	A source of the same size is copied unfiltered. Otherwise the source is filtered along one
+			axis into a temporary surface, which is then filtered along the other axis into the destination.
+			The axis filtered first is whichever needs fewer multiply-adds in total, which is usually the
+			one that shrinks the most.
+\param[out]	dest The surface to hold the scaled pixels.
+\param[in]	source The surface to scale.
+\param[in]	width The width of the scaled surface.
+\param[in]	height The height of the scaled surface.
+\param[in]	filter The filter to scale with.
+*/
+void Resampler::Scale(PixelSurface* dest, const PixelSurface* source, int width, int height, Filter filter)
+{
+	dest->Create(width, height);
+	if (dest->IsEmpty() == true || source->IsEmpty() == true)
+	{
+		return;
+	}
+	if (width == source->GetWidth() && height == source->GetHeight())
+	{
+		dest->CopyFrom(source);
+		return;
+	}
+	if (filter == FILTER_NEAREST)
+	{
+		ScaleNearest(dest, source);
+		return;
+	}
+
+	Contributors columns;
+	Contributors rows;
+	BuildContributors(filter, source->GetWidth(), width, &columns);
+	BuildContributors(filter, source->GetHeight(), height, &rows);
+	double horizontalFirst = (double)width * source->GetHeight() * columns.maxTaps + (double)width * height * rows.maxTaps;
+	double verticalFirst = (double)source->GetWidth() * height * rows.maxTaps + (double)width * height * columns.maxTaps;
+	if (horizontalFirst <= verticalFirst)
+	{
+		PixelSurface temp(width, source->GetHeight());
+		FilterHorizontal(&temp, source, &columns);
+		FilterVertical(dest, &temp, &rows);
+	}
+	else
+	{
+		PixelSurface temp(source->GetWidth(), height);
+		FilterVertical(&temp, source, &rows);
+		FilterHorizontal(dest, &temp, &columns);
+	}
+}
+
+
+/**
+\brief		Limits the kernels Scale filters with to the passed instruction set and narrower ones.
+\details	Every instruction set gives the same pixels, so this is only used to check the kernels against
+			each other and to time them. It is limited to the widest set the renderer was compiled with,
+			and must not be changed while surfaces are being scaled on other threads.
+\param[in]	instructions The widest instruction set to filter with.
+*/
+void Resampler::SetInstructionSet(InstructionSet instructions)
+{
+	InstructionSet widest = GetWidestInstructionSet();
+	instructionSet = instructions < widest ? instructions : widest;
+}
+
+
+/**
+\brief		Returns the widest instruction set Scale filters with.
+\return		The instruction set.
+*/
+Resampler::InstructionSet Resampler::GetInstructionSet(void)
+{
+	return instructionSet;
+}
+
+
+/**
+\brief		Returns the widest instruction set the renderer was compiled with, which Scale filters with
+			unless SetInstructionSet limits it.
+\return		The instruction set.
+*/
+Resampler::InstructionSet Resampler::GetWidestInstructionSet(void)
+{
+#if defined(RESAMPLER_AVX2)
+	return INSTRUCTIONS_AVX2;
+#elif defined(RESAMPLER_SSE2)
+	return INSTRUCTIONS_SSE2;
+#else
+	return INSTRUCTIONS_SCALAR;
+#endif
+}
+
+
+/**
+\brief		Filters every row of the source horizontally into the destination.
+\param[out]	dest The surface as wide as the scaled surface and as high as the source.
+\param[in]	source The surface to filter.
+\param[in]	columns The source pixels and weights of each destination column.
+*/
+void Resampler::FilterHorizontal(PixelSurface* dest, const PixelSurface* source, const Contributors* columns)
+{
+	for (int y = 0; y < dest->GetHeight(); y++)
+	{
+		int done = 0;
+		if (instructionSet >= INSTRUCTIONS_SSE2)
+		{
+			done = FilterRowSse2(dest->GetRow(y), source->GetRow(y), dest->GetWidth(), columns);
+		}
+		FilterRowScalar(dest->GetRow(y), source->GetRow(y), done, dest->GetWidth(), columns);
+	}
+}
+
+
+/**
+\brief		Filters every column of the source vertically into the destination, a row at a time.
+\param[out]	dest The surface as high as the scaled surface and as wide as the source.
+\param[in]	source The surface to filter.
+\param[in]	rows The source rows and weights of each destination row.
+*/
+void Resampler::FilterVertical(PixelSurface* dest, const PixelSurface* source, const Contributors* rows)
+{
+	int width = dest->GetWidth();
+	std::vector<const unsigned int*> tapRows(rows->maxTaps);
+	for (int y = 0; y < dest->GetHeight(); y++)
+	{
+		int taps = rows->count[y];
+		for (int k = 0; k < taps; k++)
+		{
+			tapRows[k] = source->GetRow(rows->first[y] + k);
+		}
+		const short* weights = &rows->weights[y * rows->maxTaps];
+		int done = 0;
+		if (instructionSet >= INSTRUCTIONS_AVX2)
+		{
+			done = FilterColumnsAvx2(dest->GetRow(y), &tapRows[0], weights, taps, width);
+		}
+		if (instructionSet >= INSTRUCTIONS_SSE2)
+		{
+			done += FilterColumnsSse2(dest->GetRow(y), &tapRows[0], weights, taps, done, width);
+		}
+		FilterColumnsScalar(dest->GetRow(y), &tapRows[0], weights, taps, done, width);
+	}
+}
+
+
+/**
+\brief		Returns the weight of a source pixel at the passed distance from the center of a destination pixel.
+\param[in]	filter The filter to weigh with.
+\param[in]	x The distance in source pixels, scaled down when shrinking.
+\return		The unnormalized weight.
+*/
+double Resampler::Kernel(Filter filter, double x)
+{
+	const double PI = 3.14159265358979323846;
+	x = fabs(x);
+	if (filter == FILTER_BILINEAR)
+	{
+		return x < 1.0 ? 1.0 - x : 0.0;
+	}
+	if (filter == FILTER_BOX)
+	{
+		return x <= 0.5 ? 1.0 : 0.0;
+	}
+	if (filter == FILTER_LANCZOS3)
+	{
+		if (x < 1e-8)
+		{
+			return 1.0;
+		}
+		if (x >= 3.0)
+		{
+			return 0.0;
+		}
+		return 3.0 * sin(PI * x) * sin(PI * x / 3.0) / (PI * PI * x * x);
+	}
+	return 0.0;
+}
+
+
+/**
+\brief		Returns how far from the center of a destination pixel the filter reaches.
+\param[in]	filter The filter.
+\return		The radius in source pixels before any widening.
+*/
+double Resampler::Radius(Filter filter)
+{
+	if (filter == FILTER_LANCZOS3)
+	{
+		return 3.0;
+	}
+	if (filter == FILTER_BOX)
+	{
+		return 0.5;
+	}
+	return 1.0;
+}
+
+
+/**
+\brief		Works out which source pixels make up each destination pixel along one axis, and their weights.
+\details	Box and Lanczos-3 are widened by the scale factor when shrinking so every source pixel 
+			contributes, while bilinear always blends the two closest pixels, which is cheaper but 
+			skips pixels when shrinking by more than half. Source pixels past the edges are replaced 
+			by the edge pixels, so their weights are added to the edge pixels. The weights of each 
+			destination pixel are rounded to fixed point with any rounding error added to the largest, 
+			so they always sum to ONE.
+\param[in]	filter The filter to weigh with.
+\param[in]	sourceSize The number of source pixels along the axis.
+\param[in]	destSize The number of destination pixels along the axis.
+\param[out]	contributors The source pixels and weights of each destination pixel.
+*/
+void Resampler::BuildContributors(Filter filter, int sourceSize, int destSize, Contributors* contributors)
+{
+	double scale = (double)sourceSize / destSize;
+	double filterScale = (filter != FILTER_BILINEAR && scale > 1.0) ? scale : 1.0;
+	double support = Radius(filter) * filterScale;
+	int maxTaps = (int)ceil(support * 2.0) + 1;
+	if (maxTaps > sourceSize)
+	{
+		maxTaps = sourceSize;
+	}
+	contributors->maxTaps = maxTaps;
+	contributors->first.assign(destSize, 0);
+	contributors->count.assign(destSize, 0);
+	contributors->weights.assign(destSize * maxTaps, 0);
+
+	std::vector<double> weights(maxTaps);
+	for (int i = 0; i < destSize; i++)
+	{
+		double center = (i + 0.5) * scale - 0.5;
+		int left = (int)ceil(center - support);
+		int right = (int)floor(center + support);
+		// the window of source pixels, which always holds at least one pixel inside the source
+		int first = left < 0 ? 0 : left;
+		int last = right > sourceSize - 1 ? sourceSize - 1 : right;
+		for (int k = 0; k < maxTaps; k++)
+		{
+			weights[k] = 0.0;
+		}
+		double total = 0.0;
+		for (int j = left; j <= right; j++)
+		{
+			double w = Kernel(filter, (j - center) / filterScale);
+			int index = j < first ? first : (j > last ? last : j);
+			weights[index - first] += w;
+			total += w;
+		}
+
+		// round to fixed point, keeping the sum exact
+		short* fixedWeights = &contributors->weights[i * maxTaps];
+		int sum = 0;
+		int largest = 0;
+		for (int k = 0; k <= last - first; k++)
+		{
+			fixedWeights[k] = (short)floor(weights[k] / total * ONE + 0.5);
+			sum += fixedWeights[k];
+			if (fixedWeights[k] > fixedWeights[largest])
+			{
+				largest = k;
+			}
+		}
+		fixedWeights[largest] = (short)(fixedWeights[largest] + ONE - sum);
+		contributors->first[i] = first;
+		contributors->count[i] = last - first + 1;
+	}
+}
+
+
+/**
+\brief		Scales a surface by copying the source pixel closest to the center of each destination pixel.
+\details	Destination rows that come from the same source row are copied from the row above.
+\param[out]	dest The surface to hold the scaled pixels, already created at the scaled size.
+\param[in]	source The surface to scale.
+*/
+void Resampler::ScaleNearest(PixelSurface* dest, const PixelSurface* source)
+{
+	int width = dest->GetWidth();
+	int height = dest->GetHeight();
+	std::vector<int> columns(width);
+	for (int x = 0; x < width; x++)
+	{
+		int sx = (int)((x + 0.5) * source->GetWidth() / width);
+		columns[x] = sx < source->GetWidth() ? sx : source->GetWidth() - 1;
+	}
+	int lastRow = -1;
+	for (int y = 0; y < height; y++)
+	{
+		int sy = (int)((y + 0.5) * source->GetHeight() / height);
+		sy = sy < source->GetHeight() ? sy : source->GetHeight() - 1;
+		unsigned int* row = dest->GetRow(y);
+		if (sy == lastRow)
+		{
+			memcpy(row, dest->GetRow(y - 1), width * sizeof(unsigned int));
+			continue;
+		}
+		const unsigned int* sourceRow = source->GetRow(sy);
+		for (int x = 0; x < width; x++)
+		{
+			row[x] = sourceRow[columns[x]];
+		}
+		lastRow = sy;
+	}
+}
+
+
+/**
+\brief		Rounds fixed point channel sums to a premultiplied pixel.
+\details	Each channel is clamped to 0 - 255 and the colors are clamped to the alpha, since the
+			negative lobes of Lanczos-3 can overshoot.
+\return		The packed pixel.
+*/
+unsigned int Resampler::Pack(int a, int r, int g, int b)
+{
+	const int HALF = 1 << (WEIGHT_BITS - 1);
+	a = (a + HALF) >> WEIGHT_BITS;
+	r = (r + HALF) >> WEIGHT_BITS;
+	g = (g + HALF) >> WEIGHT_BITS;
+	b = (b + HALF) >> WEIGHT_BITS;
+	a = a < 0 ? 0 : (a > 255 ? 255 : a);
+	r = r < 0 ? 0 : (r > a ? a : r);
+	g = g < 0 ? 0 : (g > a ? a : g);
+	b = b < 0 ? 0 : (b > a ? a : b);
+	return ((unsigned int)a << 24) | ((unsigned int)r << 16) | ((unsigned int)g << 8) | (unsigned int)b;
+}
+
+
+/**
+\brief		Filters a row horizontally one destination pixel and one source pixel at a time.
+\param[out]	dest The destination row.
+\param[in]	source The source row.
+\param[in]	start The first destination pixel to filter.
+\param[in]	count The number of pixels in the destination row.
+\param[in]	c The source pixels and weights of each destination pixel.
+*/
+void Resampler::FilterRowScalar(unsigned int* dest, const unsigned int* source, int start, int count, const Contributors* c)
+{
+	for (int x = start; x < count; x++)
+	{
+		const unsigned int* pixels = source + c->first[x];
+		const short* weights = &c->weights[x * c->maxTaps];
+		int a = 0, r = 0, g = 0, b = 0;
+		for (int k = 0; k < c->count[x]; k++)
+		{
+			int w = weights[k];
+			a += (int)(pixels[k] >> 24) * w;
+			r += (int)((pixels[k] >> 16) & 0xff) * w;
+			g += (int)((pixels[k] >> 8) & 0xff) * w;
+			b += (int)(pixels[k] & 0xff) * w;
+		}
+		dest[x] = Pack(a, r, g, b);
+	}
+}
+
+
+/**
+\brief		Filters a row horizontally with SSE2, two source pixels at a time.
+\details	The channels of two neighbouring source pixels are interleaved as 16 bit pairs so a single 
+			multiply-add weighs both pixels for all 4 channels.
+\param[out]	dest The destination row.
+\param[in]	source The source row.
+\param[in]	count The number of pixels in the destination row.
+\param[in]	c The source pixels and weights of each destination pixel.
+\return		The number of destination pixels filtered, either all or none.
+*/
+#ifdef RESAMPLER_SSE2
+int Resampler::FilterRowSse2(unsigned int* dest, const unsigned int* source, int count, const Contributors* c)
+{
+	int x = 0;
+	__m128i zero = _mm_setzero_si128();
+	__m128i half = _mm_set1_epi32(1 << (WEIGHT_BITS - 1));
+	for (; x < count; x++)
+	{
+		const unsigned int* pixels = source + c->first[x];
+		const short* weights = &c->weights[x * c->maxTaps];
+		int taps = c->count[x];
+		__m128i sum = half;
+		int k = 0;
+		for (; k + 2 <= taps; k += 2)
+		{
+			__m128i pair = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(pixels + k)), zero);
+			pair = _mm_unpacklo_epi16(pair, _mm_srli_si128(pair, 8));
+			__m128i w = _mm_set1_epi32((weights[k] & 0xffff) | (weights[k + 1] << 16));
+			sum = _mm_add_epi32(sum, _mm_madd_epi16(pair, w));
+		}
+		if (k < taps)
+		{
+			__m128i single = _mm_unpacklo_epi8(_mm_cvtsi32_si128((int)pixels[k]), zero);
+			single = _mm_unpacklo_epi16(single, zero);
+			sum = _mm_add_epi32(sum, _mm_madd_epi16(single, _mm_set1_epi32(weights[k] & 0xffff)));
+		}
+		// round, clamp the colors to the alpha and pack to 8 bits
+		__m128i packed = _mm_packs_epi32(_mm_srai_epi32(sum, WEIGHT_BITS), zero);
+		packed = _mm_min_epi16(packed, _mm_shufflelo_epi16(packed, _MM_SHUFFLE(3, 3, 3, 3)));
+		dest[x] = (unsigned int)_mm_cvtsi128_si32(_mm_packus_epi16(packed, zero));
+	}
+	return x;
+}
+#else
+int Resampler::FilterRowSse2(unsigned int*, const unsigned int*, int, const Contributors*)
+{
+	return 0;
+}
+#endif
+
+
+/**
+\brief		Filters the columns of a destination row vertically one pixel and one source row at a time.
+\param[out]	dest The destination row.
+\param[in]	rows The source rows of the destination row.
+\param[in]	weights The weight of each source row.
+\param[in]	taps The number of source rows.
+\param[in]	start The first destination pixel to filter.
+\param[in]	count The number of pixels in the destination row.
+*/
+void Resampler::FilterColumnsScalar(unsigned int* dest, const unsigned int* const* rows, const short* weights, int taps, int start, int count)
+{
+	for (int x = start; x < count; x++)
+	{
+		int a = 0, r = 0, g = 0, b = 0;
+		for (int k = 0; k < taps; k++)
+		{
+			unsigned int pixel = rows[k][x];
+			int w = weights[k];
+			a += (int)(pixel >> 24) * w;
+			r += (int)((pixel >> 16) & 0xff) * w;
+			g += (int)((pixel >> 8) & 0xff) * w;
+			b += (int)(pixel & 0xff) * w;
+		}
+		dest[x] = Pack(a, r, g, b);
+	}
+}
+
+
+/**
+\brief		Filters the columns of a destination row vertically with SSE2, two pixels and two source rows at a time.
+\details	The channels of the same pixel in two source rows are interleaved as 16 bit pairs so a single 
+			multiply-add weighs both rows for all 4 channels.
+\param[out]	dest The destination row.
+\param[in]	rows The source rows of the destination row.
+\param[in]	weights The weight of each source row.
+\param[in]	taps The number of source rows.
+\param[in]	start The first destination pixel to filter.
+\param[in]	count The number of pixels in the destination row.
+\return		The number of pixels filtered, a multiple of 2.
+*/
+#ifdef RESAMPLER_SSE2
+int Resampler::FilterColumnsSse2(unsigned int* dest, const unsigned int* const* rows, const short* weights, int taps, int start, int count)
+{
+	int x = start;
+	__m128i zero = _mm_setzero_si128();
+	__m128i half = _mm_set1_epi32(1 << (WEIGHT_BITS - 1));
+	for (; x + 2 <= count; x += 2)
+	{
+		__m128i sum0 = half;
+		__m128i sum1 = half;
+		for (int k = 0; k < taps; k += 2)
+		{
+			__m128i top = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(rows[k] + x)), zero);
+			__m128i bottom = zero;
+			int w = weights[k] & 0xffff;
+			if (k + 1 < taps)
+			{
+				bottom = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(rows[k + 1] + x)), zero);
+				w |= weights[k + 1] << 16;
+			}
+			__m128i pairWeights = _mm_set1_epi32(w);
+			sum0 = _mm_add_epi32(sum0, _mm_madd_epi16(_mm_unpacklo_epi16(top, bottom), pairWeights));
+			sum1 = _mm_add_epi32(sum1, _mm_madd_epi16(_mm_unpackhi_epi16(top, bottom), pairWeights));
+		}
+		// round, clamp the colors to the alpha and pack to 8 bits
+		__m128i packed = _mm_packs_epi32(_mm_srai_epi32(sum0, WEIGHT_BITS), _mm_srai_epi32(sum1, WEIGHT_BITS));
+		__m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(packed, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+		packed = _mm_min_epi16(packed, alpha);
+		_mm_storel_epi64((__m128i*)(dest + x), _mm_packus_epi16(packed, zero));
+	}
+	return x - start;
+}
+#else
+int Resampler::FilterColumnsSse2(unsigned int*, const unsigned int* const*, const short*, int, int, int)
+{
+	return 0;
+}
+#endif
+
+
+/**
+\brief		Filters the columns of a destination row vertically with AVX2, four pixels and two source rows at a time.
+\details	Uses the same interleaved multiply-add as the SSE2 kernel on 256-bit registers, with pixels
+			0 and 2 in one sum and pixels 1 and 3 in the other.
+\param[out]	dest The destination row.
+\param[in]	rows The source rows of the destination row.
+\param[in]	weights The weight of each source row.
+\param[in]	taps The number of source rows.
+\param[in]	count The number of pixels in the destination row.
+\return		The number of pixels filtered, a multiple of 4.
+*/
+#ifdef RESAMPLER_AVX2
+int Resampler::FilterColumnsAvx2(unsigned int* dest, const unsigned int* const* rows, const short* weights, int taps, int count)
+{
+	int x = 0;
+	__m256i zero = _mm256_setzero_si256();
+	__m256i half = _mm256_set1_epi32(1 << (WEIGHT_BITS - 1));
+	for (; x + 4 <= count; x += 4)
+	{
+		__m256i sum0 = half;
+		__m256i sum1 = half;
+		for (int k = 0; k < taps; k += 2)
+		{
+			__m256i top = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(rows[k] + x)));
+			__m256i bottom = zero;
+			int w = weights[k] & 0xffff;
+			if (k + 1 < taps)
+			{
+				bottom = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(rows[k + 1] + x)));
+				w |= weights[k + 1] << 16;
+			}
+			__m256i pairWeights = _mm256_set1_epi32(w);
+			sum0 = _mm256_add_epi32(sum0, _mm256_madd_epi16(_mm256_unpacklo_epi16(top, bottom), pairWeights));
+			sum1 = _mm256_add_epi32(sum1, _mm256_madd_epi16(_mm256_unpackhi_epi16(top, bottom), pairWeights));
+		}
+		// round, clamp the colors to the alpha and pack to 8 bits, then put the pixels back in order
+		__m256i packed = _mm256_packs_epi32(_mm256_srai_epi32(sum0, WEIGHT_BITS), _mm256_srai_epi32(sum1, WEIGHT_BITS));
+		__m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(packed, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+		packed = _mm256_packus_epi16(_mm256_min_epi16(packed, alpha), zero);
+		packed = _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+		_mm_storeu_si128((__m128i*)(dest + x), _mm256_castsi256_si128(packed));
+	}
+	return x;
+}
+#else
+int Resampler::FilterColumnsAvx2(unsigned int*, const unsigned int* const*, const short*, int, int)
+{
+	return 0;
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include "PixelSurface.h"
+#include <vector>
+using namespace std;
+
+
+#ifndef __RESAMPLER_H__
+#define __RESAMPLER_H__
+
+
+/**
+\class		Resampler
+\author		Tom Bisch
+\date		May 17, 2016
+\brief		Scales PixelSurface objects with a choice of filters trading speed for quality.
+\details	This is a static class holding the resampling kernels. Nearest copies the closest source pixel, 
+			bilinear blends the two closest source pixels along each axis, box averages every source pixel
+			a destination pixel covers, and Lanczos-3 uses a windowed sinc over 6 source pixels, widened 
+			when shrinking. Except for nearest, scaling is done in two separable passes, horizontally and 
+			then vertically, using 14 bit fixed point weights on the premultiplied channels, so each 
+			destination pixel is the same whether it is filtered by the scalar, SSE2 or AVX2 kernels.
+			SetInstructionSet limits the kernels used, so they can be checked and timed against each other.
+*/
+class Resampler
+{
+
+public:
+	// the filters a surface can be scaled with, from fastest to best quality
+	enum Filter
+	{
+		FILTER_NEAREST,
+		FILTER_BILINEAR,
+		FILTER_BOX,
+		FILTER_LANCZOS3
+	};
+
+	// the kernels a surface can be filtered with, from slowest to fastest
+	enum InstructionSet
+	{
+		INSTRUCTIONS_SCALAR,
+		INSTRUCTIONS_SSE2,
+		INSTRUCTIONS_AVX2
+	};
+
+private:
+	// the source pixels and weights that make up each destination pixel along one axis
+	struct Contributors
+	{
+		int maxTaps;					// the most source pixels used by any destination pixel
+		std::vector<int> first;			// the first source pixel of each destination pixel
+		std::vector<int> count;			// the number of source pixels of each destination pixel
+		std::vector<short> weights;		// maxTaps weights for each destination pixel, summing to ONE
+	};
+
+	static const int WEIGHT_BITS;		// the fractional bits of a weight
+	static const int ONE;				// a weight of 1.0
+	static InstructionSet instructionSet;	// the widest kernels Scale filters with
+
+	static double Kernel(Filter filter, double x);
+	static double Radius(Filter filter);
+	static void BuildContributors(Filter filter, int sourceSize, int destSize, Contributors* contributors);
+	static void ScaleNearest(PixelSurface* dest, const PixelSurface* source);
+	static void FilterHorizontal(PixelSurface* dest, const PixelSurface* source, const Contributors* columns);
+	static void FilterVertical(PixelSurface* dest, const PixelSurface* source, const Contributors* rows);
+	static unsigned int Pack(int a, int r, int g, int b);
+
+	static void FilterRowScalar(unsigned int* dest, const unsigned int* source, int start, int count, const Contributors* c);
+	static int FilterRowSse2(unsigned int* dest, const unsigned int* source, int count, const Contributors* c);
+	static void FilterColumnsScalar(unsigned int* dest, const unsigned int* const* rows, const short* weights, int taps, int start, int count);
+	static int FilterColumnsSse2(unsigned int* dest, const unsigned int* const* rows, const short* weights, int taps, int start, int count);
+	static int FilterColumnsAvx2(unsigned int* dest, const unsigned int* const* rows, const short* weights, int taps, int count);
+
+public:
+	static void Scale(PixelSurface* dest, const PixelSurface* source, int width, int height, Filter filter);
+	static void SetInstructionSet(InstructionSet instructions);
+	static InstructionSet GetInstructionSet(void);
+	static InstructionSet GetWidestInstructionSet(void);
+
+};
+
+
+#endif
\ No newline at end of file
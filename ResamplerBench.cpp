@@ -0,0 +1,82 @@
+/**
+\file		ResamplerBench.cpp
+\author		Tom Bisch
+\date		Jun 12, 2016
+\brief		Times how fast Resampler scales a surface with every filter and instruction set.
+\details	A random premultiplied surface the size of the background is shrunk to the size of a reptile,
+			halved and grown to a larger window, the way the game scales its images when the window is
+			resized. Each scale is repeated with every separable filter and with every instruction set the
+			renderer was compiled with, and the average time of one scale is printed, so the kernels can
+			be compared on the same machine. Nothing is checked; ResamplerCheck checks that the kernels
+			give the same pixels.
+
+			Usage: ResamplerBench [repeats]
+*/
+
+
+// include files
+#include "Resampler.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+using namespace std;
+
+
+// constants
+const int DEFAULT_REPEATS = 20;				// the number of times each scale is timed when none are passed
+const int SOURCE_WIDTH = 1280;				// the width of the surface scaled
+const int SOURCE_HEIGHT = 800;				// the height of the surface scaled
+const int SIZE_COUNT = 3;					// the number of sizes the surface is scaled to
+const int SIZES[SIZE_COUNT][2] = { { 133, 133 }, { 640, 400 }, { 1920, 1200 } };
+const char* const FILTER_NAMES[] = { "nearest", "bilinear", "box", "lanczos3" };
+const char* const INSTRUCTION_NAMES[] = { "scalar", "SSE2", "AVX2" };
+
+
+/**
+\brief		Times every scale of the benchmark and prints the average time of each.
+\param[in]	argc The number of command line arguments.
+\param[in]	argv The command line arguments: the number of times each scale is timed.
+\return		0.
+*/
+int main(int argc, char** argv)
+{
+	int repeats = argc > 1 ? atoi(argv[1]) : DEFAULT_REPEATS;
+	repeats = repeats > 0 ? repeats : 1;
+
+	unsigned int random = 1;
+	PixelSurface source(SOURCE_WIDTH, SOURCE_HEIGHT);
+	for (int y = 0; y < source.GetHeight(); y++)
+	{
+		for (int x = 0; x < source.GetWidth(); x++)
+		{
+			random = random * 1103515245 + 12345;
+			source.GetRow(y)[x] = PixelSurface::MakeArgb(random >> 24, (random >> 16) & 0xff, (random >> 8) & 0xff, random & 0xff);
+		}
+	}
+
+	Resampler::InstructionSet widest = Resampler::GetWidestInstructionSet();
+	printf("%-10s %-11s %-8s %s\n", "filter", "size", "kernels", "ms/scale");
+	// nearest copies pixels without the filter kernels, so it is the same with every instruction set
+	for (int filter = Resampler::FILTER_BILINEAR; filter <= Resampler::FILTER_LANCZOS3; filter++)
+	{
+		for (int s = 0; s < SIZE_COUNT; s++)
+		{
+			for (int set = Resampler::INSTRUCTIONS_SCALAR; set <= widest; set++)
+			{
+				Resampler::SetInstructionSet((Resampler::InstructionSet)set);
+				PixelSurface scaled;
+				Resampler::Scale(&scaled, &source, SIZES[s][0], SIZES[s][1], (Resampler::Filter)filter);
+				chrono::steady_clock::time_point start = chrono::steady_clock::now();
+				for (int r = 0; r < repeats; r++)
+				{
+					Resampler::Scale(&scaled, &source, SIZES[s][0], SIZES[s][1], (Resampler::Filter)filter);
+				}
+				double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+				printf("%-10s %4dx%-6d %-8s %.3f\n", FILTER_NAMES[filter], SIZES[s][0], SIZES[s][1], INSTRUCTION_NAMES[set],
+					seconds * 1000 / repeats);
+			}
+		}
+	}
+	Resampler::SetInstructionSet(widest);
+	return 0;
+}
@@ -0,0 +1,136 @@
+/**
+\file		ResamplerCheck.cpp
+\author		Tom Bisch
+\date		Jun 12, 2016
+\brief		Checks that the SSE2 and AVX2 kernels of Resampler give exactly the same pixels as the scalar ones.
+\details	Random premultiplied surfaces of random sizes are scaled to random sizes with every filter,
+			once with each instruction set the renderer was compiled with, and every pixel is compared
+			with the pixel filtered by the scalar kernels. The sizes cover shrinking and growing along each
+			axis, and widths that leave a remainder for the narrower kernels. The instruction sets that
+			were not compiled in are reported and skipped, so the AVX2 kernels are only checked by a build
+			compiled with AVX2.
+
+			Usage: ResamplerCheck [cases]
+*/
+
+
+// include files
+#include "Resampler.h"
+#include <cstdio>
+#include <cstdlib>
+using namespace std;
+
+
+// constants
+const int DEFAULT_CASES = 400;				// the number of surfaces scaled when none are passed
+const char* const INSTRUCTION_NAMES[] = { "scalar", "SSE2", "AVX2" };
+
+
+// prototypes
+void FillRandom(PixelSurface* surface, unsigned int* random);
+int CountDifferences(const PixelSurface* a, const PixelSurface* b);
+unsigned int NextRandom(unsigned int* random);
+
+
+/**
+\brief		Scales random surfaces with every instruction set and prints the number of pixels that differ.
+\param[in]	argc The number of command line arguments.
+\param[in]	argv The command line arguments: the number of surfaces to scale.
+\return		0 if every pixel matched the scalar kernels, 1 if any differed.
+*/
+int main(int argc, char** argv)
+{
+	int cases = argc > 1 ? atoi(argv[1]) : DEFAULT_CASES;
+	Resampler::InstructionSet widest = Resampler::GetWidestInstructionSet();
+	for (int set = widest + 1; set <= Resampler::INSTRUCTIONS_AVX2; set++)
+	{
+		printf("%s was not compiled in, skipped\n", INSTRUCTION_NAMES[set]);
+	}
+
+	unsigned int random = 1;
+	int failures = 0;
+	for (int i = 0; i < cases; i++)
+	{
+		PixelSurface source(NextRandom(&random) % 120 + 1, NextRandom(&random) % 120 + 1);
+		FillRandom(&source, &random);
+		int width = NextRandom(&random) % 200 + 1;
+		int height = NextRandom(&random) % 200 + 1;
+		Resampler::Filter filter = (Resampler::Filter)(i % (Resampler::FILTER_LANCZOS3 + 1));
+
+		PixelSurface expected;
+		Resampler::SetInstructionSet(Resampler::INSTRUCTIONS_SCALAR);
+		Resampler::Scale(&expected, &source, width, height, filter);
+		for (int set = Resampler::INSTRUCTIONS_SSE2; set <= widest; set++)
+		{
+			PixelSurface scaled;
+			Resampler::SetInstructionSet((Resampler::InstructionSet)set);
+			Resampler::Scale(&scaled, &source, width, height, filter);
+			int differences = CountDifferences(&expected, &scaled);
+			if (differences > 0)
+			{
+				failures++;
+				printf("%s differs in %d pixels: filter %d, %dx%d to %dx%d\n", INSTRUCTION_NAMES[set], differences,
+					filter, source.GetWidth(), source.GetHeight(), width, height);
+			}
+		}
+	}
+	Resampler::SetInstructionSet(widest);
+	printf("%d cases up to %s, %d differences\n", cases, INSTRUCTION_NAMES[widest], failures);
+	return failures == 0 ? 0 : 1;
+}
+
+
+/**
+\brief		Fills a surface with random premultiplied pixels, some of them transparent or opaque.
+\param[in,out]	surface The surface to fill.
+\param[in,out]	random The state of the random number generator.
+*/
+void FillRandom(PixelSurface* surface, unsigned int* random)
+{
+	for (int y = 0; y < surface->GetHeight(); y++)
+	{
+		unsigned int* row = surface->GetRow(y);
+		for (int x = 0; x < surface->GetWidth(); x++)
+		{
+			int kind = NextRandom(random) % 4;
+			int a = kind == 0 ? 0 : (kind == 1 ? 255 : NextRandom(random) % 256);
+			row[x] = PixelSurface::MakeArgb(a, NextRandom(random) % 256, NextRandom(random) % 256, NextRandom(random) % 256);
+		}
+	}
+}
+
+
+/**
+\brief		Counts the pixels that differ between two surfaces of the same size.
+\param[in]	a The first surface.
+\param[in]	b The second surface.
+\return		The number of pixels that differ, or every pixel if the sizes differ.
+*/
+int CountDifferences(const PixelSurface* a, const PixelSurface* b)
+{
+	if (a->GetWidth() != b->GetWidth() || a->GetHeight() != b->GetHeight())
+	{
+		return a->GetWidth() * a->GetHeight();
+	}
+	int differences = 0;
+	for (int y = 0; y < a->GetHeight(); y++)
+	{
+		for (int x = 0; x < a->GetWidth(); x++)
+		{
+			differences += a->GetRow(y)[x] != b->GetRow(y)[x] ? 1 : 0;
+		}
+	}
+	return differences;
+}
+
+
+/**
+\brief		Returns the next number of a linear congruential generator, the same on every platform.
+\param[in,out]	random The state of the generator.
+\return		A number from 0 to 32767.
+*/
+unsigned int NextRandom(unsigned int* random)
+{
+	*random = *random * 1103515245 + 12345;
+	return (*random >> 16) & 0x7FFF;
+}
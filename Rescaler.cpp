@@ -0,0 +1,162 @@
+#include "Rescaler.h"
+
+
+/**
+\brief		Constructs a Rescaler object that scales surfaces on the passed ThreadPool.
+\param[in]	threadPool The worker threads to scale the surfaces on.
+*/
+Rescaler::Rescaler(ThreadPool* threadPool)
+{
+	pool = threadPool;
+	isRunning = false;
+	runningWidth = 0;
+	runningHeight = 0;
+	remainingCount = 0;
+	hasPending = false;
+	pendingWidth = 0;
+	pendingHeight = 0;
+	isReady = false;
+	readyWidth = 0;
+	readyHeight = 0;
+}
+
+
+/**
+\brief		Destructor for a Rescaler. Waits for the tasks of the ThreadPool to finish.
+*/
+Rescaler::~Rescaler(void)
+{
+	// a pending request would start another batch, so drop it before waiting
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		hasPending = false;
+	}
+	pool->Wait();
+}
+
+
+/**
+\brief		Requests the passed surfaces to be scaled for the passed window size.
+\details	If a batch is already being scaled, the request replaces any earlier request waiting
+			for it. A finished batch that has not been taken yet is thrown away, since it is older.
+\param[in]	width The width of the window the surfaces are for.
+\param[in]	height The height of the window the surfaces are for.
+\param[in]	requests The surfaces to scale.
+*/
+void Rescaler::Request(int width, int height, const std::vector<ImageRequest>* requests)
+{
+	std::lock_guard<std::mutex> guard(lock);
+	isReady = false;
+	readySurfaces.clear();
+	if (isRunning == true)
+	{
+		hasPending = true;
+		pendingWidth = width;
+		pendingHeight = height;
+		pendingRequests = *requests;
+		return;
+	}
+	StartBatch(width, height, requests);
+}
+
+
+/**
+\brief		Hands over the surfaces of the latest finished batch.
+\details	The caller should hold on to the surfaces while it resizes its images for the returned
+			window size, so the resizes find them in the ImageCache.
+\param[out]	width The width of the window the surfaces are for.
+\param[out]	height The height of the window the surfaces are for.
+\param[out]	surfaces The scaled surfaces.
+\return		True if a finished batch was taken, false if none is ready.
+*/
+bool Rescaler::TakeReady(int* width, int* height, std::vector<std::shared_ptr<const PixelSurface> >* surfaces)
+{
+	std::lock_guard<std::mutex> guard(lock);
+	if (isReady == false)
+	{
+		return false;
+	}
+	*width = readyWidth;
+	*height = readyHeight;
+	surfaces->swap(readySurfaces);
+	readySurfaces.clear();
+	isReady = false;
+	return true;
+}
+
+
+/**
+\brief		Checks if surfaces are being scaled or are waiting to be taken.
+\return		True if a batch is running or ready.
+*/
+bool Rescaler::IsBusy(void)
+{
+	std::lock_guard<std::mutex> guard(lock);
+	return isRunning == true || isReady == true;
+}
+
+
+/**
+\brief		Queues a task on the ThreadPool for every requested surface. Must be called with the lock held.
+\param[in]	width The width of the window the surfaces are for.
+\param[in]	height The height of the window the surfaces are for.
+\param[in]	requests The surfaces to scale.
+*/
+void Rescaler::StartBatch(int width, int height, const std::vector<ImageRequest>* requests)
+{
+	isRunning = true;
+	runningWidth = width;
+	runningHeight = height;
+	remainingCount = requests->size();
+	runningSurfaces.assign(requests->size(), std::shared_ptr<const PixelSurface>());
+	if (remainingCount == 0)
+	{
+		FinishBatch();
+		return;
+	}
+	for (unsigned int i = 0; i < requests->size(); i++)
+	{
+		pool->Run(std::bind(&Rescaler::ScaleSurface, this, i, (*requests)[i]));
+	}
+}
+
+
+/**
+\brief		Publishes the running batch, or starts the waiting request instead if there is one.
+			Must be called with the lock held.
+*/
+void Rescaler::FinishBatch(void)
+{
+	isRunning = false;
+	if (hasPending == true)
+	{
+		hasPending = false;
+		std::vector<ImageRequest> requests;
+		requests.swap(pendingRequests);
+		StartBatch(pendingWidth, pendingHeight, &requests);
+		return;
+	}
+	isReady = true;
+	readyWidth = runningWidth;
+	readyHeight = runningHeight;
+	readySurfaces.swap(runningSurfaces);
+	runningSurfaces.clear();
+}
+
+
+/**
+\brief		Scales a single surface of the running batch. Runs on a worker thread.
+\param[in]	index The position of the surface in the batch.
+\param[in]	request The surface to scale.
+*/
+void Rescaler::ScaleSurface(int index, ImageRequest request)
+{
+	std::shared_ptr<const PixelSurface> surface = ImageCache::Get(&request);
+	std::lock_guard<std::mutex> guard(lock);
+	runningSurfaces[index] = surface;
+	remainingCount--;
+	if (remainingCount == 0)
+	{
+		FinishBatch();
+	}
+}
\ No newline at end of file
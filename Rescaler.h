@@ -0,0 +1,60 @@
+#include "ImageCache.h"
+#include "ThreadPool.h"
+#include <vector>
+#include <memory>
+#include <mutex>
+using namespace std;
+
+
+#ifndef __RESCALER_H__
+#define __RESCALER_H__
+
+
+/**
+\class		Rescaler
+\author		Tom Bisch
+\date		May 12, 2016
+\brief		Scales the images for a new window size on worker threads.
+\details	Each call to Request describes the surfaces needed for a window size, and every surface is 
+			scaled through the ImageCache as a separate task on a ThreadPool. Requests are coalesced: 
+			while a batch is being scaled only the latest request is kept, and it is started once the 
+			running batch finishes, whose result is thrown away. The finished surfaces are held until 
+			they are taken at a frame boundary with TakeReady, so until then the images keep drawing 
+			their previous surfaces, and afterwards resizing them only swaps in surfaces from the cache.
+*/
+class Rescaler
+{
+
+private:
+	ThreadPool* pool;					// the worker threads the surfaces are scaled on
+	std::mutex lock;					// guards everything below
+	bool isRunning;						// indicates if a batch is being scaled
+	int runningWidth;					// the window width of the running batch
+	int runningHeight;					// the window height of the running batch
+	int remainingCount;					// the number of surfaces of the running batch still being scaled
+	std::vector<std::shared_ptr<const PixelSurface> > runningSurfaces;	// the surfaces of the running batch
+	bool hasPending;					// indicates if a request is waiting for the running batch
+	int pendingWidth;					// the window width of the waiting request
+	int pendingHeight;					// the window height of the waiting request
+	std::vector<ImageRequest> pendingRequests;	// the surfaces of the waiting request
+	bool isReady;						// indicates if a finished batch is waiting to be taken
+	int readyWidth;						// the window width of the finished batch
+	int readyHeight;					// the window height of the finished batch
+	std::vector<std::shared_ptr<const PixelSurface> > readySurfaces;	// the surfaces of the finished batch
+
+	void StartBatch(int width, int height, const std::vector<ImageRequest>* requests);
+	void FinishBatch(void);
+	void ScaleSurface(int index, ImageRequest request);
+
+public:
+	Rescaler(ThreadPool* threadPool);
+	~Rescaler(void);
+
+	void Request(int width, int height, const std::vector<ImageRequest>* requests);
+	bool TakeReady(int* width, int* height, std::vector<std::shared_ptr<const PixelSurface> >* surfaces);
+	bool IsBusy(void);
+
+};
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,221 @@
+#include "RotationCache.h"
+
+
+// class constants
+const int RotationCache::STEP_DEGREES = 5;
+const int RotationCache::MEMORY_LIMIT = 16 * 1024 * 1024;
+
+
+/**
+\brief		Constructs an empty RotationCache object.
+*/
+RotationCache::RotationCache(void)
+{
+	frames.resize(360 / STEP_DEGREES);
+	lastUsed.assign(frames.size(), 0);
+	isPinned.assign(frames.size(), 0);
+	useCount = 0;
+	memoryUsed = 0;
+}
+
+
+/**
+\brief		Destructor for a RotationCache. The frames free their own pixels.
+*/
+RotationCache::~RotationCache(void)
+{
+}
+
+
+/**
+\brief		Draws the passed surface rotated about its center, rounded to the nearest cached angle.
+\details	The frame for the angle is blended if Prepare has rendered it, otherwise the surface is
+			rotated straight onto the target, which draws the same pixels more slowly. Nothing is
+			rendered or freed, so the cache can be drawn from several threads at once. Rotations of 
+			0 degrees are not cached since the surface can be blended as it is.
+\param[in]	target The surface to draw onto.
+\param[in]	source The surface the cache is built from.
+\param[in]	x The X coordinate of the unrotated source.
+\param[in]	y The Y coordinate of the unrotated source.
+\param[in]	degrees The rotation of the source in degrees.
+\param[in]	sampling How a new frame samples the source, the cache must be cleared to change it.
+*/
+void RotationCache::Draw(PixelSurface* target, const PixelSurface* source, int x, int y, int degrees, PixelSurface::Sampling sampling) const
+{
+	const PixelSurface* frame = Find(source, degrees);
+	if (frame == NULL)
+	{
+		target->BlendRotated(source, x, y, Quantize(degrees), sampling);
+		return;
+	}
+	PixelRect bounds = Bounds(x, y, source->GetWidth(), source->GetHeight(), degrees);
+	target->Blend(frame, bounds.x, bounds.y);
+}
+
+
+/**
+\brief		Renders the frame for the nearest cached angle if it has not been rendered yet.
+\details	The frame is pinned, so it is not freed until Unpin is called. If the new frame would take
+			the cache over MEMORY_LIMIT bytes, the least recently used frames that are not pinned are
+			freed first, and if that does not make enough room the frame is not rendered at all and
+			Draw rotates the surface directly. Prepare must not be called while the cache is drawn.
+\param[in]	source The surface the cache is built from.
+\param[in]	degrees The rotation of the source in degrees.
+\param[in]	sampling How a new frame samples the source, the cache must be cleared to change it.
+\return		The frame for the angle, the source itself for a rotation of 0 degrees, or NULL if the frame does not fit.
+*/
+const PixelSurface* RotationCache::Prepare(const PixelSurface* source, int degrees, PixelSurface::Sampling sampling)
+{
+	int angle = Quantize(degrees);
+	if (angle == 0)
+	{
+		return source;
+	}
+	int step = angle / STEP_DEGREES;
+	PixelSurface* frame = &frames[step];
+	if (frame->IsEmpty() == true)
+	{
+		PixelRect bounds = Bounds(0, 0, source->GetWidth(), source->GetHeight(), angle);
+		// room is made for the padded rows the frame is created with, which is what it is charged
+		if (MakeRoom(PixelSurface::PaddedStride(bounds.width) * bounds.height * 4) == false)
+		{
+			return NULL;
+		}
+		// blending onto a transparent frame copies each pixel exactly, so the frame blends like the source
+		frame->Create(bounds.width, bounds.height);
+		frame->BlendRotated(source, -bounds.x, -bounds.y, angle, sampling);
+		memoryUsed += frame->GetStride() * frame->GetHeight() * 4;
+	}
+	lastUsed[step] = ++useCount;
+	isPinned[step] = 1;
+	return frame;
+}
+
+
+/**
+\brief		Returns the frame for the nearest cached angle without rendering it.
+\param[in]	source The surface the cache is built from.
+\param[in]	degrees The rotation of the source in degrees.
+\return		The frame for the angle, the source itself for a rotation of 0 degrees, or NULL if it has not been rendered.
+*/
+const PixelSurface* RotationCache::Find(const PixelSurface* source, int degrees) const
+{
+	int angle = Quantize(degrees);
+	if (angle == 0)
+	{
+		return source;
+	}
+	const PixelSurface* frame = &frames[angle / STEP_DEGREES];
+	return frame->IsEmpty() == true ? NULL : frame;
+}
+
+
+/**
+\brief		Lets the frames prepared so far be freed to make room for new ones.
+\details	Called before preparing the frames of the next scene, once the last scene has been drawn.
+*/
+void RotationCache::Unpin(void)
+{
+	isPinned.assign(frames.size(), 0);
+}
+
+
+/**
+\brief		Frees every frame, so each angle is rendered again from the surface when next drawn.
+*/
+void RotationCache::Clear(void)
+{
+	for (unsigned int i = 0; i < frames.size(); i++)
+	{
+		frames[i].Release();
+	}
+	isPinned.assign(frames.size(), 0);
+	memoryUsed = 0;
+}
+
+
+/**
+\brief		Counts the angles that have a rendered frame.
+\return		The number of rendered frames.
+*/
+int RotationCache::FrameCount(void)
+{
+	int count = 0;
+	for (unsigned int i = 0; i < frames.size(); i++)
+	{
+		if (frames[i].IsEmpty() == false)
+		{
+			count++;
+		}
+	}
+	return count;
+}
+
+
+/**
+\brief		Returns the memory used by the frames.
+\return		The bytes of pixels held by the rendered frames.
+*/
+int RotationCache::GetMemoryUsed(void)
+{
+	return memoryUsed;
+}
+
+
+/**
+\brief		Rounds a rotation to the nearest cached angle.
+\param[in]	degrees The rotation in degrees, which may be negative or more than 360.
+\return		The cached angle from 0 to 360 - STEP_DEGREES.
+*/
+int RotationCache::Quantize(int degrees)
+{
+	degrees %= 360;
+	if (degrees < 0)
+	{
+		degrees += 360;
+	}
+	return ((degrees + STEP_DEGREES / 2) / STEP_DEGREES * STEP_DEGREES) % 360;
+}
+
+
+/**
+\brief		Returns the bounding box a surface is drawn over by Draw.
+\param[in]	x The X coordinate of the unrotated surface.
+\param[in]	y The Y coordinate of the unrotated surface.
+\param[in]	w The width of the surface.
+\param[in]	h The height of the surface.
+\param[in]	degrees The rotation of the surface in degrees.
+\return		The bounds of the surface rotated to the nearest cached angle.
+*/
+PixelRect RotationCache::Bounds(int x, int y, int w, int h, int degrees)
+{
+	return PixelSurface::RotatedBounds(x, y, w, h, Quantize(degrees));
+}
+
+
+/**
+\brief		Frees the least recently used frames that are not pinned until a new frame fits under MEMORY_LIMIT.
+\param[in]	bytes The bytes of pixels the new frame needs.
+\return		True if the frame fits, false if it would not fit even with every unpinned frame freed.
+*/
+bool RotationCache::MakeRoom(int bytes)
+{
+	while (memoryUsed + bytes > MEMORY_LIMIT)
+	{
+		int oldest = -1;
+		for (unsigned int i = 0; i < frames.size(); i++)
+		{
+			if (frames[i].IsEmpty() == false && isPinned[i] == 0 && (oldest < 0 || lastUsed[i] < lastUsed[oldest]))
+			{
+				oldest = i;
+			}
+		}
+		if (oldest < 0)
+		{
+			return false;
+		}
+		memoryUsed -= frames[oldest].GetStride() * frames[oldest].GetHeight() * 4;
+		frames[oldest].Release();
+	}
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "PixelSurface.h"
+#include <vector>
+using namespace std;
+
+
+#ifndef __ROTATION_CACHE_H__
+#define __ROTATION_CACHE_H__
+
+
+/**
+\class		RotationCache
+\author		Tom Bisch
+\date		May 20, 2016
+\brief		Keeps copies of a surface pre-rotated to a fixed set of angles.
+\details	Rotations are rounded to the nearest multiple of STEP_DEGREES, and the first time a surface
+			is prepared at one of those angles it is rotated onto a frame of its own. Later draws at the 
+			same angle blend that frame, which costs no more than drawing an unrotated surface. Frames
+			are only rendered for the angles actually prepared, and when a new frame would take the cache
+			over MEMORY_LIMIT bytes the least recently used frames are freed to make room. Frames prepared
+			since the last Unpin are never freed, so every frame prepared for the scene being drawn stays
+			valid while it is drawn, and an angle that does not fit is drawn by rotating the surface
+			directly instead. Drawing never renders or frees a frame, so it can be done from several
+			threads at once. The cache must be cleared whenever the surface it was built from changes,
+			for example after a resize.
+*/
+class RotationCache
+{
+
+private:
+	std::vector<PixelSurface> frames;	// the rotated surface at each step, empty until first prepared
+	std::vector<unsigned int> lastUsed;	// the use count when each frame was last prepared
+	std::vector<unsigned char> isPinned;	// indicates if each frame has been prepared since the last Unpin
+	unsigned int useCount;				// the number of times a frame has been prepared
+	int memoryUsed;						// the bytes of pixels held by the frames
+
+	bool MakeRoom(int bytes);
+
+public:
+	static const int STEP_DEGREES;		// the angle between cached rotations, a divisor of 360
+	static const int MEMORY_LIMIT;		// the most bytes of pixels the frames may use
+
+	RotationCache(void);
+	~RotationCache(void);
+
+	void Draw(PixelSurface* target, const PixelSurface* source, int x, int y, int degrees, 
+		PixelSurface::Sampling sampling = PixelSurface::SAMPLING_NEAREST) const;
+	const PixelSurface* Prepare(const PixelSurface* source, int degrees, 
+		PixelSurface::Sampling sampling = PixelSurface::SAMPLING_NEAREST);
+	const PixelSurface* Find(const PixelSurface* source, int degrees) const;
+	void Unpin(void);
+	void Clear(void);
+	int FrameCount(void);
+	int GetMemoryUsed(void);
+
+	static int Quantize(int degrees);
+	static PixelRect Bounds(int x, int y, int w, int h, int degrees);
+
+};
+
+
+#endif
\ No newline at end of file
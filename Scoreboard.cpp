@@ -3,41 +3,26 @@
 
 // class constants
 int Scoreboard::SECOND_LIMIT = 33;
-int Scoreboard::totalScore = 0;
-int Scoreboard::roundScore = 100;
-int Scoreboard::secondCounter = 0;
-int Scoreboard::round = 1;
-bool Scoreboard::isRoundActive = true;
 
 
 /**
-\brief		Draws the scoreboard stats to the window using the passed Gdiplus::Graphics pointer.
-\param[in]	g The pointer to the graphics object used to draw to the window.
-\param[in]	windowWidth The width of the window to draw to.
-\param[in]	windowHeight The height of the window to draw to.
+\brief		Constructs a Scoreboard object for the first round of a new game.
+*/
+Scoreboard::Scoreboard(void)
+{
+	totalScore = 0;
+	roundScore = 100;
+	secondCounter = 0;
+	round = 1;
+	isRoundActive = true;
+}
+
+
+/**
+\brief		Destructor for a Scoreboard. Currently does nothing.
 */
-void Scoreboard::Draw(Gdiplus::Graphics* g, int windowWidth, int windowHeight)
+Scoreboard::~Scoreboard(void)
 {
-	Gdiplus::Font font(L"Vrinda", 12); // font
-	Gdiplus::SolidBrush brush(Gdiplus::Color::Black); // brush (color)
-	
-	// total score
-	wstring tScoreString = L"total score : " + to_wstring(totalScore);
-	const WCHAR* tScoreWCHAR = tScoreString.c_str();
-	Gdiplus::PointF tScorePoint(0, 0);
-	g->DrawString(tScoreWCHAR, tScoreString.length(), &font, tScorePoint, &brush);
-
-	// round score
-	wstring rScoreString = L"round score : " + to_wstring(roundScore);
-	const WCHAR* rScoreWCHAR = rScoreString.c_str();
-	Gdiplus::PointF rScorePoint(0, 15);
-	g->DrawString(rScoreWCHAR, rScoreString.length(), &font, rScorePoint, &brush);
-
-	// round number
-	wstring roundNumberString = L"round : " + to_wstring(round);
-	const WCHAR* roundNumberWCHAR = roundNumberString.c_str();
-	Gdiplus::PointF roundPoint(Gdiplus::REAL(windowWidth / 2), 0);
-	g->DrawString(roundNumberWCHAR, roundNumberString.length(), &font, roundPoint, &brush);
 }
 
 
@@ -110,4 +95,33 @@ void Scoreboard::AddPoints(int points)
 }
 
 
+/**
+\brief		Returns the total score of the Unhappy Flying Reptiles game.
+\return		The player's total score in the game.
+*/
+int Scoreboard::GetTotalScore(void)
+{
+	return totalScore;
+}
+
+
+/**
+\brief		Returns the score of the current round of the Unhappy Flying Reptiles game.
+\return		The player's score in the current round.
+*/
+int Scoreboard::GetRoundScore(void)
+{
+	return roundScore;
+}
+
+
+/**
+\brief		Returns the current round number of the Unhappy Flying Reptiles game.
+\return		The current round in the game.
+*/
+int Scoreboard::GetRound(void)
+{
+	return round;
+}
+
 
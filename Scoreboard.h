@@ -1,10 +1,3 @@
-#include <windows.h>
-#include <gdiplus.h>
-#include <string>
-using namespace Gdiplus;
-using namespace std;
-
-
 #ifndef __SCOREBOARD_H__
 #define __SCOREBOARD_H__
 
@@ -14,28 +7,34 @@ using namespace std;
 \author		Tom Bisch
 \date		April 5, 2016
 \brief		Represents the scoreboard for the Unhappy Flying Reptiles game.
-\details	Contains methods for drawing game stats to the window, updating the game stats on a regular interval,
-			ending a round in the game, starting a new round in the game and adding points to the total score.
-			This is a static class that belongs to all objects in the Unhapppy Flying Reptiles game.
+\details	Contains methods for updating the game stats on a regular interval, ending a round in the game,
+			starting a new round in the game, adding points to the total score and getting the game stats
+			so they can be drawn to the window. Each World owns its own Scoreboard so that games can be 
+			simulated independently of each other.
 */
 class Scoreboard
 {
 
 private:
-	static int totalScore;				// player total score in the game
-	static int roundScore;				// player score in the current round
-	static int secondCounter;			// counts up to SECOND_LIMIT
-	static int round;					// current round in the game
-	static bool isRoundActive;			// indicates if reptile has been hit or not
+	int totalScore;						// player total score in the game
+	int roundScore;						// player score in the current round
+	int secondCounter;					// counts up to SECOND_LIMIT
+	int round;							// current round in the game
+	bool isRoundActive;					// indicates if reptile has been hit or not
 
 public:
 	static int SECOND_LIMIT;			// number of refresh cycles until roundScore is decremented
 
-	static void Draw(Gdiplus::Graphics* g, int windowWidth, int windowHeight);
-	static bool Update(int windowWidth, int windowHeight);
-	static void EndRound(void);
-	static void StartNextRound(void);
-	static void AddPoints(int points);
+	Scoreboard(void);
+	~Scoreboard(void);
+
+	bool Update(int windowWidth, int windowHeight);
+	void EndRound(void);
+	void StartNextRound(void);
+	void AddPoints(int points);
+	int GetTotalScore(void);
+	int GetRoundScore(void);
+	int GetRound(void);
 
 };
 
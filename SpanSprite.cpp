@@ -0,0 +1,163 @@
+#include "SpanSprite.h"
+#include <cstring>
+
+
+/**
+\brief		Constructs an empty SpanSprite object.
+*/
+SpanSprite::SpanSprite(void)
+{
+	surface = NULL;
+	memset(&stats, 0, sizeof(stats));
+}
+
+
+/**
+\brief		Destructor for a SpanSprite. Currently does nothing.
+*/
+SpanSprite::~SpanSprite(void)
+{
+}
+
+
+/**
+\brief		Encodes the rows of the passed surface as runs of opaque and partly transparent pixels.
+\param[in]	source The surface to encode, which must outlive the runs or be rebuilt.
+*/
+void SpanSprite::Build(const PixelSurface* source)
+{
+	surface = source;
+	runs.clear();
+	rowStarts.clear();
+	stats.transparentPixels = 0;
+	stats.opaquePixels = 0;
+	stats.partialPixels = 0;
+	for (int y = 0; y < source->GetHeight(); y++)
+	{
+		rowStarts.push_back((int)runs.size());
+		const unsigned int* row = source->GetRow(y);
+		int x = 0;
+		while (x < source->GetWidth())
+		{
+			unsigned int alpha = row[x] >> 24;
+			int start = x;
+			// a run continues while the pixels are all transparent, all opaque or all partial
+			if (row[x] == 0)
+			{
+				while (x < source->GetWidth() && row[x] == 0)
+				{
+					x++;
+				}
+				stats.transparentPixels += x - start;
+				continue;
+			}
+			if (alpha == 255)
+			{
+				while (x < source->GetWidth() && (row[x] >> 24) == 255)
+				{
+					x++;
+				}
+				stats.opaquePixels += x - start;
+			}
+			else
+			{
+				while (x < source->GetWidth() && row[x] != 0 && (row[x] >> 24) != 255)
+				{
+					x++;
+				}
+				stats.partialPixels += x - start;
+			}
+			Run run = { start, x - start, alpha == 255 };
+			runs.push_back(run);
+		}
+	}
+	rowStarts.push_back((int)runs.size());
+	stats.runCount = (int)runs.size();
+}
+
+
+/**
+\brief		Draws the encoded surface onto the target, limited to the target's clip rectangle.
+\details	Gives the same pixels as PixelSurface::Blend, but never reads the transparent pixels.
+			The sprite is only read, so it can be drawn onto several surfaces at once.
+\param[in]	target The surface to draw onto.
+\param[in]	x The X coordinate to draw the sprite at.
+\param[in]	y The Y coordinate to draw the sprite at.
+*/
+void SpanSprite::Draw(PixelSurface* target, int x, int y)
+{
+	if (surface == NULL)
+	{
+		return;
+	}
+	// the part of the sprite inside the clip rectangle, in sprite coordinates
+	PixelRect clip = target->GetClip();
+	int left = clip.x - x > 0 ? clip.x - x : 0;
+	int top = clip.y - y > 0 ? clip.y - y : 0;
+	int right = clip.x + clip.width - x < surface->GetWidth() ? clip.x + clip.width - x : surface->GetWidth();
+	int bottom = clip.y + clip.height - y < surface->GetHeight() ? clip.y + clip.height - y : surface->GetHeight();
+	if (left >= right || top >= bottom)
+	{
+		return;
+	}
+	for (int row = top; row < bottom; row++)
+	{
+		unsigned int* dest = target->GetRow(y + row) + x;
+		const unsigned int* src = surface->GetRow(row);
+		for (int i = rowStarts[row]; i < rowStarts[row + 1]; i++)
+		{
+			int first = runs[i].x > left ? runs[i].x : left;
+			int last = runs[i].x + runs[i].length < right ? runs[i].x + runs[i].length : right;
+			if (first >= last)
+			{
+				continue;
+			}
+			if (runs[i].isOpaque == true)
+			{
+				memcpy(dest + first, src + first, (last - first) * sizeof(unsigned int));
+			}
+			else
+			{
+				for (int j = first; j < last; j++)
+				{
+					dest[j] = PixelSurface::BlendPixel(src[j], dest[j]);
+				}
+			}
+		}
+	}
+}
+
+
+/**
+\brief		Forgets the runs, for example when the surface they were built from is freed.
+*/
+void SpanSprite::Clear(void)
+{
+	surface = NULL;
+	runs.clear();
+	rowStarts.clear();
+	stats.transparentPixels = 0;
+	stats.opaquePixels = 0;
+	stats.partialPixels = 0;
+	stats.runCount = 0;
+}
+
+
+/**
+\brief		Returns how much of the sprite is transparent, opaque or partly transparent.
+\return		A pointer to the statistics of the sprite.
+*/
+const SpanStats* SpanSprite::GetStats(void)
+{
+	return &stats;
+}
+
+
+/**
+\brief		Indicates if the sprite has any runs to draw.
+\return		True if the sprite has not been built.
+*/
+bool SpanSprite::IsEmpty(void)
+{
+	return surface == NULL;
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include "PixelSurface.h"
+#include <vector>
+using namespace std;
+
+
+#ifndef __SPAN_SPRITE_H__
+#define __SPAN_SPRITE_H__
+
+
+// how much of a sprite is transparent, opaque or partly transparent
+struct SpanStats
+{
+	int transparentPixels;				// the pixels that are entirely 0, which are never touched
+	int opaquePixels;					// the pixels with an alpha of 255, which are copied
+	int partialPixels;					// every other pixel, which is blended
+	int runCount;						// the number of opaque and partial runs in all the rows
+};
+
+
+/**
+\class		SpanSprite
+\author		Tom Bisch
+\date		May 24, 2016
+\brief		A copy of a surface's alpha layout encoded as runs of pixels along each row.
+\details	Each row is stored as the runs of opaque and partly transparent pixels it contains, and the 
+			gaps between runs are transparent. Drawing skips the gaps without reading them, copies opaque
+			runs with memcpy and only blends the partly transparent pixels, which for most sprites are
+			just the antialiased edges. The runs refer to the pixels of the surface they were built from, 
+			so they must be built again whenever that surface changes. The sprite also counts how many 
+			of its pixels are of each kind, to show how much fill rate each sprite can save. Drawing only
+			reads the sprite, so the tile threads drawing the same sprite never wait for each other.
+*/
+class SpanSprite
+{
+
+private:
+	// a run of opaque or partly transparent pixels in a row
+	struct Run
+	{
+		int x;							// the first pixel of the run
+		int length;						// the number of pixels in the run
+		bool isOpaque;					// indicates if every pixel of the run is opaque
+	};
+
+	const PixelSurface* surface;		// the surface the runs were built from
+	std::vector<Run> runs;				// the runs of every row, in order
+	std::vector<int> rowStarts;			// the first run of each row, followed by the number of runs
+	SpanStats stats;					// the layout of the sprite
+
+public:
+	SpanSprite(void);
+	~SpanSprite(void);
+
+	void Build(const PixelSurface* source);
+	void Draw(PixelSurface* target, int x, int y);
+	void Clear(void);
+	const SpanStats* GetStats(void);
+	bool IsEmpty(void);
+
+};
+
+
+#endif
\ No newline at end of file
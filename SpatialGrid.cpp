@@ -0,0 +1,239 @@
+#include "SpatialGrid.h"
+#include <algorithm>
+
+
+// class constants
+const int SpatialGrid::CELL_SIZE = 64;
+
+
+/**
+\brief		Constructs an empty SpatialGrid object with a single cell.
+*/
+SpatialGrid::SpatialGrid(void)
+{
+	columns = 1;
+	rows = 1;
+	cells.resize(1);
+}
+
+
+/**
+\brief		Destructor for a SpatialGrid. Currently does nothing.
+*/
+SpatialGrid::~SpatialGrid(void)
+{
+}
+
+
+/**
+\brief		Sizes the grid to cover the passed world and lists the objects again in the new cells.
+\param[in]	worldWidth The width of the world, normally the width of the window.
+\param[in]	worldHeight The height of the world, normally the height of the window.
+*/
+void SpatialGrid::SetSize(int worldWidth, int worldHeight)
+{
+	int newColumns = worldWidth > 0 ? (worldWidth + CELL_SIZE - 1) / CELL_SIZE : 1;
+	int newRows = worldHeight > 0 ? (worldHeight + CELL_SIZE - 1) / CELL_SIZE : 1;
+	if (newColumns == columns && newRows == rows)
+	{
+		return;
+	}
+	columns = newColumns;
+	rows = newRows;
+	cells.assign(columns * rows, std::vector<int>());
+	for (unsigned int i = 0; i < objects.size(); i++)
+	{
+		if (objects[i].isPlaced == true)
+		{
+			AddToCells(i);
+		}
+	}
+}
+
+
+/**
+\brief		Places an object in the grid, or moves it if it has already been placed.
+\details	The cell lists are only changed when the object moves into different cells.
+\param[in]	index The index of the object, chosen by the caller.
+\param[in]	x The X coordinate of the object's bounding box.
+\param[in]	y The Y coordinate of the object's bounding box.
+\param[in]	width The width of the object's bounding box.
+\param[in]	height The height of the object's bounding box.
+*/
+void SpatialGrid::Place(int index, int x, int y, int width, int height)
+{
+	if (index >= (int)objects.size())
+	{
+		Bounds empty = { 0, 0, 0, 0, 0, 0, 0, 0, false };
+		objects.resize(index + 1, empty);
+	}
+
+	Bounds* bounds = &objects[index];
+	bounds->left = x;
+	bounds->top = y;
+	bounds->right = x + width;
+	bounds->bottom = y + height;
+	if (bounds->isPlaced == true)
+	{
+		if (ColumnOf(bounds->left) == bounds->firstColumn && RowOf(bounds->top) == bounds->firstRow &&
+			ColumnOf(bounds->right) == bounds->lastColumn && RowOf(bounds->bottom) == bounds->lastRow)
+		{
+			return;
+		}
+		RemoveFromCells(index);
+	}
+	bounds->isPlaced = true;
+	AddToCells(index);
+}
+
+
+/**
+\brief		Takes an object out of the grid, if it has been placed.
+\param[in]	index The index of the object.
+*/
+void SpatialGrid::Remove(int index)
+{
+	if (index < (int)objects.size() && objects[index].isPlaced == true)
+	{
+		RemoveFromCells(index);
+		objects[index].isPlaced = false;
+	}
+}
+
+
+/**
+\brief		Takes every object out of the grid, keeping its size.
+*/
+void SpatialGrid::Clear(void)
+{
+	objects.clear();
+	for (unsigned int i = 0; i < cells.size(); i++)
+	{
+		cells[i].clear();
+	}
+}
+
+
+/**
+\brief		Finds the objects whose bounding boxes overlap the passed box.
+\param[in]	x The X coordinate of the box.
+\param[in]	y The Y coordinate of the box.
+\param[in]	width The width of the box.
+\param[in]	height The height of the box.
+\param[out]	found Replaced by the indices of the overlapping objects, in increasing order.
+*/
+void SpatialGrid::Query(int x, int y, int width, int height, std::vector<int>* found) const
+{
+	found->clear();
+	Bounds box = { x, y, x + width, y + height, 0, 0, 0, 0, true };
+	for (int row = RowOf(box.top); row <= RowOf(box.bottom); row++)
+	{
+		for (int column = ColumnOf(box.left); column <= ColumnOf(box.right); column++)
+		{
+			const std::vector<int>* cell = &cells[row * columns + column];
+			for (unsigned int i = 0; i < cell->size(); i++)
+			{
+				// an object sharing several cells with the box is only found in the first of them
+				const Bounds* bounds = &objects[(*cell)[i]];
+				if (Overlaps(bounds, &box) == true &&
+					ColumnOf(bounds->left > box.left ? bounds->left : box.left) == column &&
+					RowOf(bounds->top > box.top ? bounds->top : box.top) == row)
+				{
+					found->push_back((*cell)[i]);
+				}
+			}
+		}
+	}
+	std::sort(found->begin(), found->end());
+}
+
+
+/**
+\brief		Returns the number of object indices in use, including any removed objects below the highest.
+\return		One more than the highest index placed since the grid was last cleared.
+*/
+int SpatialGrid::ObjectCount(void)
+{
+	return objects.size();
+}
+
+
+/**
+\brief		Lists an object in every cell its bounding box covers.
+\param[in]	index The index of the object.
+*/
+void SpatialGrid::AddToCells(int index)
+{
+	Bounds* bounds = &objects[index];
+	bounds->firstColumn = ColumnOf(bounds->left);
+	bounds->firstRow = RowOf(bounds->top);
+	bounds->lastColumn = ColumnOf(bounds->right);
+	bounds->lastRow = RowOf(bounds->bottom);
+	for (int row = bounds->firstRow; row <= bounds->lastRow; row++)
+	{
+		for (int column = bounds->firstColumn; column <= bounds->lastColumn; column++)
+		{
+			cells[row * columns + column].push_back(index);
+		}
+	}
+}
+
+
+/**
+\brief		Takes an object out of every cell it is listed in.
+\param[in]	index The index of the object.
+*/
+void SpatialGrid::RemoveFromCells(int index)
+{
+	Bounds* bounds = &objects[index];
+	for (int row = bounds->firstRow; row <= bounds->lastRow; row++)
+	{
+		for (int column = bounds->firstColumn; column <= bounds->lastColumn; column++)
+		{
+			std::vector<int>* cell = &cells[row * columns + column];
+			cell->erase(std::find(cell->begin(), cell->end(), index));
+		}
+	}
+}
+
+
+/**
+\brief		Returns the column of cells holding the passed X coordinate, limited to the grid.
+\param[in]	x The X coordinate.
+\return		The column, from 0 to the number of columns - 1.
+*/
+int SpatialGrid::ColumnOf(int x) const
+{
+	if (x < 0)
+	{
+		return 0;
+	}
+	return x / CELL_SIZE < columns ? x / CELL_SIZE : columns - 1;
+}
+
+
+/**
+\brief		Returns the row of cells holding the passed Y coordinate, limited to the grid.
+\param[in]	y The Y coordinate.
+\return		The row, from 0 to the number of rows - 1.
+*/
+int SpatialGrid::RowOf(int y) const
+{
+	if (y < 0)
+	{
+		return 0;
+	}
+	return y / CELL_SIZE < rows ? y / CELL_SIZE : rows - 1;
+}
+
+
+/**
+\brief		Checks if two bounding boxes overlap, counting boxes that only touch at an edge.
+\param[in]	a The first bounding box.
+\param[in]	b The second bounding box.
+\return		True if the boxes overlap or touch.
+*/
+bool SpatialGrid::Overlaps(const Bounds* a, const Bounds* b)
+{
+	return a->left <= b->right && b->left <= a->right && a->top <= b->bottom && b->top <= a->bottom;
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include <vector>
+using namespace std;
+
+
+#ifndef __SPATIAL_GRID_H__
+#define __SPATIAL_GRID_H__
+
+
+/**
+\class		SpatialGrid
+\author		Tom Bisch
+\date		Jun 3, 2016
+\brief		A uniform grid over the world that finds the game objects whose bounding boxes touch.
+\details	The world is cut into square cells of CELL_SIZE pixels and each object is listed in every
+			cell its bounding box covers, so finding what an object touches only looks at the objects
+			in its own cells instead of at every object. Objects are identified by an index chosen by
+			the caller and are placed again each frame; an object that stays in the same cells only has
+			its bounds updated. Bounding boxes include their edges, so boxes that only touch count as
+			overlapping, the same as the collision checks of Box. Objects outside of the world are listed
+			in the cells along its edge. Results are sorted by index, so they do not depend on the
+			order the objects were placed in. Queries do not change the grid, so several threads may
+			query it at once as long as no object is being placed or removed.
+*/
+class SpatialGrid
+{
+
+private:
+	// the bounding box of an object and the cells it is listed in
+	struct Bounds
+	{
+		int left;						// the X coordinate of the left edge
+		int top;						// the Y coordinate of the top edge
+		int right;						// the X coordinate of the right edge, included in the box
+		int bottom;						// the Y coordinate of the bottom edge, included in the box
+		int firstColumn;				// the first column of cells the box covers
+		int firstRow;					// the first row of cells the box covers
+		int lastColumn;					// the last column of cells the box covers
+		int lastRow;					// the last row of cells the box covers
+		bool isPlaced;					// indicates if the object is in the grid
+	};
+
+	std::vector<Bounds> objects;				// the bounds of each object, by index
+	std::vector<std::vector<int> > cells;		// the objects in each cell, row by row
+	int columns;								// the number of cells across the grid
+	int rows;									// the number of cells down the grid
+
+	void AddToCells(int index);
+	void RemoveFromCells(int index);
+	int ColumnOf(int x) const;
+	int RowOf(int y) const;
+	static bool Overlaps(const Bounds* a, const Bounds* b);
+
+public:
+	static const int CELL_SIZE;			// the width and height of each cell
+
+	SpatialGrid(void);
+	~SpatialGrid(void);
+
+	void SetSize(int worldWidth, int worldHeight);
+	void Place(int index, int x, int y, int width, int height);
+	void Remove(int index);
+	void Clear(void);
+	void Query(int x, int y, int width, int height, std::vector<int>* found) const;
+
+	int ObjectCount(void);
+
+};
+
+
+#endif
\ No newline at end of file
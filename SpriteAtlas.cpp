@@ -0,0 +1,270 @@
+#include "SpriteAtlas.h"
+#include <algorithm>
+
+
+// class constants
+const int SpriteAtlas::PAGE_WIDTH = 1024;
+const int SpriteAtlas::MAX_PAGE_HEIGHT = 1024;
+const int SpriteAtlas::MAX_SPRITE_SIZE = 512;
+
+
+/**
+\brief		Constructs an empty SpriteAtlas object.
+*/
+SpriteAtlas::SpriteAtlas(void)
+{
+}
+
+
+/**
+\brief		Destructor for a SpriteAtlas. The pages are freed once no BitmapImage is drawn from them.
+*/
+SpriteAtlas::~SpriteAtlas(void)
+{
+}
+
+
+/**
+\brief		Packs the surfaces of the passed BitmapImages into pages and draws them from the pages.
+\details	Sprites wider or higher than MAX_SPRITE_SIZE, and empty sprites, are left as they are. The
+			previous pages are released by the atlas, and are freed as the BitmapImages move off them.
+\param[in]	sprites The BitmapImages to pack, whose surfaces are replaced by their packed copies.
+*/
+void SpriteAtlas::Build(const std::vector<BitmapImage*>* sprites)
+{
+	Clear();
+
+	// pack the highest sprites first, which leaves the fewest gaps under the skyline
+	std::vector<BitmapImage*> order;
+	for (unsigned int i = 0; i < sprites->size(); i++)
+	{
+		const PixelSurface* surface = (*sprites)[i]->GetSurface();
+		if (surface->IsEmpty() == false && 
+			surface->GetWidth() <= MAX_SPRITE_SIZE && surface->GetHeight() <= MAX_SPRITE_SIZE)
+		{
+			order.push_back((*sprites)[i]);
+		}
+	}
+	std::stable_sort(order.begin(), order.end(), IsHigher);
+
+	// place every sprite on the first page it fits on, opening a page when none has room
+	for (unsigned int i = 0; i < order.size(); i++)
+	{
+		Placement placement;
+		placement.name = order[i]->GetName();
+		placement.page = 0;
+		const PixelSurface* surface = order[i]->GetSurface();
+		while (placement.page < (int)skylines.size() && 
+			Insert(placement.page, surface->GetWidth(), surface->GetHeight(), &placement.rect) == false)
+		{
+			placement.page++;
+		}
+		if (placement.page == (int)skylines.size())
+		{
+			SkylineNode node = { 0, 0, PAGE_WIDTH };
+			skylines.push_back(std::vector<SkylineNode>(1, node));
+			Insert(placement.page, surface->GetWidth(), surface->GetHeight(), &placement.rect);
+		}
+		placements.push_back(placement);
+	}
+
+	// allocate each page only as high as its sprites reach, then copy the sprites in
+	for (unsigned int i = 0; i < skylines.size(); i++)
+	{
+		std::shared_ptr<PixelSurface> page(new PixelSurface(PAGE_WIDTH, PageHeight(i)));
+		pages.push_back(page);
+	}
+	for (unsigned int i = 0; i < order.size(); i++)
+	{
+		std::shared_ptr<PixelSurface> page = pages[placements[i].page];
+		const PixelRect* rect = &placements[i].rect;
+		page->Copy(order[i]->GetSurface(), rect->x, rect->y);
+		// the view keeps its page alive for as long as a BitmapImage is drawn from it
+		std::shared_ptr<PageView> view(new PageView());
+		view->page = page;
+		view->surface.Attach(page->GetRow(rect->y) + rect->x, rect->width, rect->height, page->GetStride());
+		order[i]->SetSurface(std::shared_ptr<const PixelSurface>(view, &view->surface));
+	}
+}
+
+
+/**
+\brief		Finds the lowest place on a page for a sprite and adds it to the page's skyline.
+\param[in]	page The page to place the sprite on.
+\param[in]	w The width of the sprite.
+\param[in]	h The height of the sprite.
+\param[out]	rect The rectangle of the sprite on the page, if it fits.
+\return		True if the sprite fits on the page.
+*/
+bool SpriteAtlas::Insert(int page, int w, int h, PixelRect* rect)
+{
+	std::vector<SkylineNode>& skyline = skylines[page];
+	// sprites start on aligned pixels, so the space they take is rounded up to the alignment
+	int pixelsPerAlignment = PixelSurface::ALIGNMENT / sizeof(unsigned int);
+	int alignedWidth = (w + pixelsPerAlignment - 1) / pixelsPerAlignment * pixelsPerAlignment;
+	int best = -1;
+	int bestY = MAX_PAGE_HEIGHT;
+	for (unsigned int i = 0; i < skyline.size(); i++)
+	{
+		int y = Fit(page, i, alignedWidth, h);
+		if (y >= 0 && y < bestY)
+		{
+			best = i;
+			bestY = y;
+		}
+	}
+	if (best < 0)
+	{
+		return false;
+	}
+	rect->x = skyline[best].x;
+	rect->y = bestY;
+	rect->width = w;
+	rect->height = h;
+
+	// the sprite's top edge replaces the segments it covers
+	SkylineNode node = { rect->x, bestY + h, alignedWidth };
+	skyline.insert(skyline.begin() + best, node);
+	unsigned int i = best + 1;
+	while (i < skyline.size() && skyline[i].x < node.x + node.width)
+	{
+		int overlap = node.x + node.width - skyline[i].x;
+		if (overlap < skyline[i].width)
+		{
+			skyline[i].x += overlap;
+			skyline[i].width -= overlap;
+			break;
+		}
+		skyline.erase(skyline.begin() + i);
+	}
+	// merge neighbouring segments at the same height
+	for (i = 0; i + 1 < skyline.size(); )
+	{
+		if (skyline[i].y == skyline[i + 1].y)
+		{
+			skyline[i].width += skyline[i + 1].width;
+			skyline.erase(skyline.begin() + i + 1);
+		}
+		else
+		{
+			i++;
+		}
+	}
+	return true;
+}
+
+
+/**
+\brief		Finds how high a sprite sits if its left edge is placed at the start of a skyline segment.
+\param[in]	page The page to place the sprite on.
+\param[in]	node The segment the left edge of the sprite is placed on.
+\param[in]	w The width of the sprite, rounded up to the alignment.
+\param[in]	h The height of the sprite.
+\return		The top of the sprite, or -1 if it runs off the page.
+*/
+int SpriteAtlas::Fit(int page, int node, int w, int h)
+{
+	const std::vector<SkylineNode>& skyline = skylines[page];
+	if (skyline[node].x + w > PAGE_WIDTH)
+	{
+		return -1;
+	}
+	// the sprite rests on the highest segment underneath it
+	int y = 0;
+	int remaining = w;
+	for (unsigned int i = node; remaining > 0; i++)
+	{
+		y = skyline[i].y > y ? skyline[i].y : y;
+		remaining -= skyline[i].width;
+	}
+	return y + h <= MAX_PAGE_HEIGHT ? y : -1;
+}
+
+
+/**
+\brief		Orders sprites from the highest to the lowest.
+\param[in]	a The first sprite.
+\param[in]	b The second sprite.
+\return		True if the first sprite is higher than the second.
+*/
+bool SpriteAtlas::IsHigher(BitmapImage* a, BitmapImage* b)
+{
+	return a->GetSurface()->GetHeight() > b->GetSurface()->GetHeight();
+}
+
+
+/**
+\brief		Finds the number of rows of a page that its sprites reach.
+\param[in]	page The page to measure.
+\return		The height of the highest segment of the page's skyline.
+*/
+int SpriteAtlas::PageHeight(int page)
+{
+	int height = 0;
+	for (unsigned int i = 0; i < skylines[page].size(); i++)
+	{
+		height = skylines[page][i].y > height ? skylines[page][i].y : height;
+	}
+	return height;
+}
+
+
+/**
+\brief		Releases the pages and forgets the placements. BitmapImages still drawn from a page keep it alive.
+*/
+void SpriteAtlas::Clear(void)
+{
+	pages.clear();
+	skylines.clear();
+	placements.clear();
+}
+
+
+/**
+\brief		Returns the number of pages the sprites were packed into.
+\return		The number of pages.
+*/
+int SpriteAtlas::PageCount(void)
+{
+	return (int)pages.size();
+}
+
+
+/**
+\brief		Returns the number of sprites that were packed.
+\return		The number of packed sprites.
+*/
+int SpriteAtlas::SpriteCount(void)
+{
+	return (int)placements.size();
+}
+
+
+/**
+\brief		Writes the size and fill of each page, and the rectangle of each sprite, as text.
+\details	Meant for checking the packing while debugging, one line per page and per sprite.
+\param[in]	out The stream to write the layout to.
+*/
+void SpriteAtlas::DumpLayout(std::wostream& out)
+{
+	for (unsigned int i = 0; i < pages.size(); i++)
+	{
+		long long used = 0;
+		for (unsigned int j = 0; j < placements.size(); j++)
+		{
+			if (placements[j].page == (int)i)
+			{
+				used += (long long)placements[j].rect.width * placements[j].rect.height;
+			}
+		}
+		long long area = (long long)pages[i]->GetWidth() * pages[i]->GetHeight();
+		out << L"page " << i << L": " << pages[i]->GetWidth() << L"x" << pages[i]->GetHeight() 
+			<< L", " << (area > 0 ? used * 100 / area : 0) << L"% filled" << endl;
+	}
+	for (unsigned int i = 0; i < placements.size(); i++)
+	{
+		const PixelRect* rect = &placements[i].rect;
+		out << L"  " << placements[i].name << L": page " << placements[i].page << L" at " << rect->x << L"," 
+			<< rect->y << L" size " << rect->width << L"x" << rect->height << endl;
+	}
+}
\ No newline at end of file
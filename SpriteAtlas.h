@@ -0,0 +1,81 @@
+#include "BitmapImage.h"
+#include "PixelSurface.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <ostream>
+using namespace std;
+
+
+#ifndef __SPRITE_ATLAS_H__
+#define __SPRITE_ATLAS_H__
+
+
+/**
+\class		SpriteAtlas
+\author		Tom Bisch
+\date		May 26, 2016
+\brief		Packs the surfaces of many small BitmapImages into a few large surfaces.
+\details	The sprites are sorted by height and placed with a skyline packer, which keeps the lowest 
+			edge of the filled area along the width of a page and puts each sprite where it leaves that
+			edge lowest. Each page is a single allocation, cut down to the height the sprites fill, and
+			every packed BitmapImage is given a surface attached to its rectangle of a page, so the 
+			sprites drawn in a frame sit next to each other in memory. A page is freed once no BitmapImage
+			is drawn from it, so the atlas can simply be built again after every resize. Sprites start on
+			a multiple of ALIGNMENT bytes so their rows stay aligned for the blit kernels.
+*/
+class SpriteAtlas
+{
+
+private:
+	// a horizontal segment of the top edge of the filled area of a page
+	struct SkylineNode
+	{
+		int x;							// the left of the segment
+		int y;							// the height filled below the segment
+		int width;						// the width of the segment
+	};
+
+	// where a sprite was packed
+	struct Placement
+	{
+		wstring name;					// the name of the BitmapImage
+		int page;						// the page the sprite is on
+		PixelRect rect;					// the rectangle of the sprite on its page
+	};
+
+	// a surface attached to a rectangle of a page, which keeps the page alive
+	struct PageView
+	{
+		std::shared_ptr<PixelSurface> page;	// the page the pixels belong to
+		PixelSurface surface;			// the pixels of the sprite on the page
+	};
+
+	std::vector<std::shared_ptr<PixelSurface> > pages;	// the packed surfaces
+	std::vector<std::vector<SkylineNode> > skylines;	// the top edge of the filled area of each page
+	std::vector<Placement> placements;	// every packed sprite, in packing order
+
+	bool Insert(int page, int w, int h, PixelRect* rect);
+	int Fit(int page, int node, int w, int h);
+	int PageHeight(int page);
+
+	static bool IsHigher(BitmapImage* a, BitmapImage* b);
+
+public:
+	static const int PAGE_WIDTH;		// the width of each page in pixels
+	static const int MAX_PAGE_HEIGHT;	// the most rows a page can have
+	static const int MAX_SPRITE_SIZE;	// the largest width or height of a sprite that is packed
+
+	SpriteAtlas(void);
+	~SpriteAtlas(void);
+
+	void Build(const std::vector<BitmapImage*>* sprites);
+	void Clear(void);
+	int PageCount(void);
+	int SpriteCount(void);
+	void DumpLayout(std::wostream& out);
+
+};
+
+
+#endif
\ No newline at end of file
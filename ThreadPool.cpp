@@ -0,0 +1,211 @@
+#include "ThreadPool.h"
+
+
+/**
+\brief		Constructs a ThreadPool object and starts its worker threads.
+\param[in]	threadCount The number of worker threads, or 0 for one less than the number of
+			hardware threads, leaving one for the window, with a minimum of one.
+*/
+ThreadPool::ThreadPool(int threadCount)
+{
+	runningCount = 0;
+	isStopping = false;
+	if (threadCount <= 0)
+	{
+		threadCount = (int)std::thread::hardware_concurrency() - 1;
+	}
+	if (threadCount < 1)
+	{
+		threadCount = 1;
+	}
+	for (int i = 0; i < threadCount; i++)
+	{
+		workers.push_back(std::thread(&ThreadPool::WorkerLoop, this));
+	}
+}
+
+
+/**
+\brief		Destructor for a ThreadPool. Finishes the queued tasks and joins the worker threads.
+*/
+ThreadPool::~ThreadPool(void)
+{
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		isStopping = true;
+	}
+	taskQueued.notify_all();
+	for (unsigned int i = 0; i < workers.size(); i++)
+	{
+		workers[i].join();
+	}
+}
+
+
+/**
+\brief		Queues a task to be run by the next idle worker thread.
+\param[in]	task The function to run.
+*/
+void ThreadPool::Run(std::function<void(void)> task)
+{
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		tasks.push_back(task);
+	}
+	taskQueued.notify_one();
+}
+
+
+/**
+\brief		Blocks until every queued task has finished.
+*/
+void ThreadPool::Wait(void)
+{
+	std::unique_lock<std::mutex> guard(lock);
+	while (tasks.empty() == false || runningCount > 0)
+	{
+		taskFinished.wait(guard);
+	}
+}
+
+
+/**
+\brief		Runs a task for every item from 0 to count - 1 on the workers and the calling thread.
+\details	The items are dealt out in order, in one run of neighbouring items for each thread. Each 
+			thread takes its own items from the front, and once they run out steals from the back of 
+			the other threads' items, so the items are spread evenly even if some take much longer than 
+			others. Returns once every item has been run. The items may run in any order and on any 
+			thread, so each must only change state that no other item reads.
+\param[in]	count The number of items.
+\param[in]	task The function run with the index of each item.
+*/
+void ThreadPool::ParallelFor(int count, std::function<void(int)> task)
+{
+	int threadCount = ThreadCount() + 1 < count ? ThreadCount() + 1 : count;
+	if (threadCount <= 1)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			task(i);
+		}
+		return;
+	}
+
+	Batch batch(threadCount);
+	batch.task = task;
+	batch.runningCount = threadCount - 1;
+	for (int i = 0; i < count; i++)
+	{
+		batch.queues[(long long)i * threadCount / count].items.push_back(i);
+	}
+	for (int i = 1; i < threadCount; i++)
+	{
+		Run(std::bind(&ThreadPool::StealLoop, this, &batch, i));
+	}
+	StealLoop(&batch, 0);
+
+	std::unique_lock<std::mutex> guard(batch.lock);
+	while (batch.runningCount > 0)
+	{
+		batch.finished.wait(guard);
+	}
+}
+
+
+/**
+\brief		Returns the number of worker threads.
+\return		The number of worker threads.
+*/
+int ThreadPool::ThreadCount(void)
+{
+	return workers.size();
+}
+
+
+/**
+\brief		Takes and runs tasks until the ThreadPool is stopped and the queue is empty.
+*/
+void ThreadPool::WorkerLoop(void)
+{
+	std::unique_lock<std::mutex> guard(lock);
+	while (true)
+	{
+		while (tasks.empty() == true && isStopping == false)
+		{
+			taskQueued.wait(guard);
+		}
+		if (tasks.empty() == true)
+		{
+			return;
+		}
+		std::function<void(void)> task = tasks.front();
+		tasks.pop_front();
+		runningCount++;
+		guard.unlock();
+		task();
+		guard.lock();
+		runningCount--;
+		taskFinished.notify_all();
+	}
+}
+
+
+/**
+\brief		Runs the items of a ParallelFor loop until there are none left to take or steal.
+\param[in]	batch The loop being run.
+\param[in]	self The index of the items of this thread, 0 for the thread that called ParallelFor.
+*/
+void ThreadPool::StealLoop(Batch* batch, int self)
+{
+	int threadCount = batch->queues.size();
+	int item;
+	while (true)
+	{
+		bool isTaken = TakeItem(&batch->queues[self], true, &item);
+		for (int i = 1; i < threadCount && isTaken == false; i++)
+		{
+			isTaken = TakeItem(&batch->queues[(self + i) % threadCount], false, &item);
+		}
+		if (isTaken == false)
+		{
+			break;
+		}
+		batch->task(item);
+	}
+
+	// the calling thread waits for the workers, and the batch is freed once it stops waiting
+	if (self != 0)
+	{
+		std::unique_lock<std::mutex> guard(batch->lock);
+		batch->runningCount--;
+		batch->finished.notify_all();
+	}
+}
+
+
+/**
+\brief		Takes an item of a ParallelFor loop from the front of a thread's items, or steals it from the back.
+\param[in]	queue The items to take from.
+\param[in]	isOwner Indicates if the items belong to the thread taking the item.
+\param[out]	item The item taken.
+\return		True if an item was taken, false if there were none left.
+*/
+bool ThreadPool::TakeItem(StealQueue* queue, bool isOwner, int* item)
+{
+	std::unique_lock<std::mutex> guard(queue->lock);
+	if (queue->items.empty() == true)
+	{
+		return false;
+	}
+	if (isOwner == true)
+	{
+		*item = queue->items.front();
+		queue->items.pop_front();
+	}
+	else
+	{
+		*item = queue->items.back();
+		queue->items.pop_back();
+	}
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+using namespace std;
+
+
+#ifndef __THREAD_POOL_H__
+#define __THREAD_POOL_H__
+
+
+/**
+\class		ThreadPool
+\author		Tom Bisch
+\date		May 12, 2016
+\brief		Runs tasks on a fixed set of worker threads.
+\details	Tasks are queued with Run and taken by the first idle worker in the order they were queued.
+			The workers are started when the ThreadPool is constructed and joined when it is destroyed,
+			after every queued task has finished. ParallelFor runs a loop on the workers and the calling
+			thread, each taking items from its own share of the loop and stealing from the others once
+			its share runs out, so uneven items still keep every thread busy.
+*/
+class ThreadPool
+{
+
+private:
+	// the share of the items of a ParallelFor loop held by one of the threads running it
+	struct StealQueue
+	{
+		std::deque<int> items;							// the items not yet taken, taken from the front by their owner
+		std::mutex lock;								// guards the items
+	};
+
+	// a loop being run by ParallelFor
+	struct Batch
+	{
+		Batch(int queueCount) : queues(queueCount) {}
+
+		std::vector<StealQueue> queues;					// the items of each thread running the loop
+		std::function<void(int)> task;					// the function run for each item
+		std::mutex lock;								// guards the running count
+		std::condition_variable finished;				// signalled when a worker has run out of items
+		int runningCount;								// the number of workers still running the loop
+	};
+
+	std::vector<std::thread> workers;				// the worker threads
+	std::deque<std::function<void(void)> > tasks;	// the tasks not yet taken by a worker
+	std::mutex lock;								// guards the task queue and counters
+	std::condition_variable taskQueued;				// signalled when a task is queued or the pool stops
+	std::condition_variable taskFinished;			// signalled when a worker finishes a task
+	int runningCount;								// the number of tasks being run by workers
+	bool isStopping;								// indicates if the workers should exit once the queue is empty
+
+	void WorkerLoop(void);
+	void StealLoop(Batch* batch, int self);
+	static bool TakeItem(StealQueue* queue, bool isOwner, int* item);
+
+public:
+	ThreadPool(int threadCount = 0);
+	~ThreadPool(void);
+
+	void Run(std::function<void(void)> task);
+	void Wait(void);
+	void ParallelFor(int count, std::function<void(int)> task);
+	int ThreadCount(void);
+
+};
+
+
+#endif
\ No newline at end of file
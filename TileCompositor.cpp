@@ -0,0 +1,224 @@
+#include "TileCompositor.h"
+
+
+// class constants
+const int TileCompositor::TILE_SIZE = 64;
+
+
+/**
+\brief		Constructs a TileCompositor object that draws its tiles on the passed ThreadPool.
+\param[in]	threadPool The worker threads to draw the tiles on, or NULL to draw every tile on the calling thread.
+*/
+TileCompositor::TileCompositor(ThreadPool* threadPool)
+{
+	pool = threadPool;
+	target = NULL;
+	columns = 0;
+	nextTile = 0;
+}
+
+
+/**
+\brief		Destructor for a TileCompositor. The tiles are finished before Compose returns.
+*/
+TileCompositor::~TileCompositor(void)
+{
+}
+
+
+/**
+\brief		Adds a sprite to the end of the draw list.
+\details	The sprite is only drawn onto the tiles its bounds overlap, so the bounds must cover every
+			pixel it draws. The draw function is called once for every overlapping tile, possibly on
+			different threads at once, with a surface clipped to the tile.
+\param[in]	bounds The pixels the sprite may draw over.
+\param[in]	draw The function that draws the sprite onto the passed surface.
+*/
+void TileCompositor::Add(PixelRect bounds, std::function<void(PixelSurface*)> draw)
+{
+	Entry entry = { bounds, draw };
+	entries.push_back(entry);
+}
+
+
+/**
+\brief		Empties the draw list, ready for the next frame.
+*/
+void TileCompositor::Clear(void)
+{
+	entries.clear();
+}
+
+
+/**
+\brief		Draws the draw list onto the dirty rectangles of the passed surface.
+\details	Returns once every tile has been drawn. The calling thread draws tiles as well, so the
+			frame is drawn even while the workers are busy with other tasks.
+\param[in]	surface The surface to draw onto, normally the window's back buffer.
+\param[in]	region The rectangles of the surface to redraw, none of which overlap.
+*/
+void TileCompositor::Compose(PixelSurface* surface, DirtyRegion* region)
+{
+	// cut the dirty rectangles into tiles, noting which cell of the grid each tile is in
+	target = surface;
+	columns = (surface->GetWidth() + TILE_SIZE - 1) / TILE_SIZE;
+	int rows = (surface->GetHeight() + TILE_SIZE - 1) / TILE_SIZE;
+	if ((int)cells.size() < columns * rows)
+	{
+		cells.resize(columns * rows);
+	}
+	for (int i = 0; i < columns * rows; i++)
+	{
+		cells[i].clear();
+	}
+	tiles.clear();
+	for (int i = 0; i < region->RectCount(); i++)
+	{
+		SplitTiles(region->GetRect(i));
+	}
+	if (tiles.empty() == true)
+	{
+		return;
+	}
+
+	// bin the entries into the tiles they overlap, looking only at the tiles in the cells they cover,
+	// the lists keep their memory between frames
+	if (bins.size() < tiles.size())
+	{
+		bins.resize(tiles.size());
+	}
+	for (unsigned int t = 0; t < tiles.size(); t++)
+	{
+		bins[t].clear();
+	}
+	for (unsigned int i = 0; i < entries.size(); i++)
+	{
+		PixelRect* bounds = &entries[i].bounds;
+		int left = bounds->x > 0 ? bounds->x : 0;
+		int top = bounds->y > 0 ? bounds->y : 0;
+		int right = bounds->x + bounds->width < surface->GetWidth() ? bounds->x + bounds->width : surface->GetWidth();
+		int bottom = bounds->y + bounds->height < surface->GetHeight() ? bounds->y + bounds->height : surface->GetHeight();
+		if (left >= right || top >= bottom)
+		{
+			continue;
+		}
+		for (int row = top / TILE_SIZE; row <= (bottom - 1) / TILE_SIZE; row++)
+		{
+			for (int column = left / TILE_SIZE; column <= (right - 1) / TILE_SIZE; column++)
+			{
+				std::vector<int>* cell = &cells[row * columns + column];
+				for (unsigned int c = 0; c < cell->size(); c++)
+				{
+					PixelRect* tile = &tiles[(*cell)[c]];
+					if (left < tile->x + tile->width && tile->x < right && top < tile->y + tile->height && tile->y < bottom)
+					{
+						bins[(*cell)[c]].push_back(i);
+					}
+				}
+			}
+		}
+	}
+
+	// share out the tiles between the workers and this thread
+	nextTile = 0;
+	if (pool != NULL)
+	{
+		int workerCount = pool->ThreadCount() < (int)tiles.size() - 1 ? pool->ThreadCount() : (int)tiles.size() - 1;
+		for (int i = 0; i < workerCount; i++)
+		{
+			pool->Run(std::bind(&TileCompositor::DrawTiles, this));
+		}
+	}
+	DrawTiles();
+	if (pool != NULL)
+	{
+		pool->Wait();
+	}
+}
+
+
+/**
+\brief		Returns the number of sprites in the draw list.
+\return		The number of sprites added since the list was last cleared.
+*/
+int TileCompositor::EntryCount(void)
+{
+	return entries.size();
+}
+
+
+/**
+\brief		Returns the number of tiles drawn by the last Compose.
+\return		The number of tiles the dirty region was cut into.
+*/
+int TileCompositor::TileCount(void)
+{
+	return tiles.size();
+}
+
+
+/**
+\brief		Cuts a rectangle into tiles along the grid and adds them to the list of tiles.
+\details	The tiles in the middle of the rectangle are TILE_SIZE square, those along its edges
+			are cut down to the rectangle, and any part of the rectangle off the target is left out.
+\param[in]	rect The rectangle to cut into tiles.
+*/
+void TileCompositor::SplitTiles(const PixelRect* rect)
+{
+	int left = rect->x > 0 ? rect->x : 0;
+	int top = rect->y > 0 ? rect->y : 0;
+	int right = rect->x + rect->width < target->GetWidth() ? rect->x + rect->width : target->GetWidth();
+	int bottom = rect->y + rect->height < target->GetHeight() ? rect->y + rect->height : target->GetHeight();
+	for (int y = top; y < bottom; y = (y / TILE_SIZE + 1) * TILE_SIZE)
+	{
+		int tileBottom = (y / TILE_SIZE + 1) * TILE_SIZE < bottom ? (y / TILE_SIZE + 1) * TILE_SIZE : bottom;
+		for (int x = left; x < right; x = (x / TILE_SIZE + 1) * TILE_SIZE)
+		{
+			int tileRight = (x / TILE_SIZE + 1) * TILE_SIZE < right ? (x / TILE_SIZE + 1) * TILE_SIZE : right;
+			PixelRect tile = { x, y, tileRight - x, tileBottom - y };
+			cells[(y / TILE_SIZE) * columns + x / TILE_SIZE].push_back(tiles.size());
+			tiles.push_back(tile);
+		}
+	}
+}
+
+
+/**
+\brief		Takes and draws tiles until every tile has been taken.
+\details	Each thread draws through a view of its own attached to the target's pixels, so setting
+			the clip of one tile does not change the clip another thread is drawing with.
+*/
+void TileCompositor::DrawTiles(void)
+{
+	PixelSurface view;
+	view.Attach(target->GetPixels(), target->GetWidth(), target->GetHeight(), target->GetStride());
+	while (true)
+	{
+		int index;
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			if (nextTile >= tiles.size())
+			{
+				return;
+			}
+			index = nextTile;
+			nextTile++;
+		}
+		DrawTile(&view, index);
+	}
+}
+
+
+/**
+\brief		Draws the entries binned into a tile, clipped to the tile.
+\param[in]	view The view of the target to draw through.
+\param[in]	index The index of the tile to draw.
+*/
+void TileCompositor::DrawTile(PixelSurface* view, int index)
+{
+	view->SetClip(&tiles[index]);
+	for (unsigned int i = 0; i < bins[index].size(); i++)
+	{
+		entries[bins[index][i]].draw(view);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include "PixelSurface.h"
+#include "DirtyRegion.h"
+#include "ThreadPool.h"
+#include <vector>
+#include <functional>
+#include <mutex>
+using namespace std;
+
+
+#ifndef __TILE_COMPOSITOR_H__
+#define __TILE_COMPOSITOR_H__
+
+
+/**
+\class		TileCompositor
+\author		Tom Bisch
+\date		May 28, 2016
+\brief		Draws a list of sprites onto the dirty parts of a surface, split into tiles drawn in parallel.
+\details	The draw list is added in painter's order, each entry with the bounds it covers. The dirty
+			rectangles are cut into tiles along a grid of TILE_SIZE pixels, and each tile is given the
+			entries whose bounds overlap it, keeping their order. Each entry is only tested against the
+			tiles in the cells of the grid it covers, so thousands of small sprites bin quickly. The 
+			tiles are shared out between the worker threads and the calling thread, and each tile is 
+			drawn by one thread through its own view of the surface, clipped to the tile. The dirty 
+			rectangles never overlap, so no two tiles touch the same pixel, and every pixel is drawn by
+			the same entries in the same order as drawing the whole list once per rectangle, whichever
+			thread draws it. Entries may only read shared state while they draw, so anything built on
+			first use must be built beforehand.
+*/
+class TileCompositor
+{
+
+private:
+	// a sprite to draw and the part of the surface it covers
+	struct Entry
+	{
+		PixelRect bounds;								// the pixels the entry may draw over
+		std::function<void(PixelSurface*)> draw;		// draws the entry onto the passed surface
+	};
+
+	ThreadPool* pool;									// the worker threads the tiles are drawn on, or NULL
+	std::vector<Entry> entries;							// the draw list, in painter's order
+	std::vector<PixelRect> tiles;						// the tiles of the dirty region being drawn
+	std::vector<std::vector<int> > bins;				// the entries overlapping each tile, in painter's order
+	std::vector<std::vector<int> > cells;				// the tiles in each cell of the grid, row by row
+	int columns;										// the number of cells across the grid
+	PixelSurface* target;								// the surface being drawn onto
+	std::mutex lock;									// guards the next tile
+	unsigned int nextTile;								// the first tile not yet taken by a thread
+
+	void SplitTiles(const PixelRect* rect);
+	void DrawTiles(void);
+	void DrawTile(PixelSurface* view, int index);
+
+public:
+	static const int TILE_SIZE;			// the width and height of the grid the tiles are cut from
+
+	TileCompositor(ThreadPool* threadPool);
+	~TileCompositor(void);
+
+	void Add(PixelRect bounds, std::function<void(PixelSurface*)> draw);
+	void Clear(void);
+	void Compose(PixelSurface* surface, DirtyRegion* region);
+	int EntryCount(void);
+	int TileCount(void);
+
+};
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,815 @@
+#include "World.h"
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+
+// class constants
+const int World::TIMESTEP = 30;
+const int World::BOX_SIZE = 48;
+const int World::FALL_SPEED = 5;
+const int World::ISLAND_BOXES = 64;
+const double World::GROUND = 0.82;
+const int World::SHOT_NONE = 0;
+const int World::SHOT_MISS = 1;
+const int World::SHOT_HIT = 2;
+
+
+/**
+\brief		Constructs a World object with the boxes stacked at their starting positions.
+\details	The boxes are built from the BoxStructure::PYRAMID description, a pyramid with one box 
+			on top, two boxes in the middle and three boxes on the ground, until another description
+			is loaded.
+\param[in]	worldWidth The width of the world, normally the width of the window.
+\param[in]	worldHeight The height of the world, normally the height of the window.
+\param[in]	seed The seed for the random numbers that drive the reptile's flight path.
+*/
+World::World(int worldWidth, int worldHeight, unsigned int seed) : reptile(seed)
+{
+	width = worldWidth;
+	height = worldHeight;
+	frameCount = 0;
+	for (int i = 0; i < Reptile::FRAME_COUNT; i++)
+	{
+		frameMasks[i] = NULL;
+	}
+
+	boxWidth = BOX_SIZE;
+	boxHeight = BOX_SIZE;
+	groundY = 0;
+	knockedDownCount = 0;
+	islandCount = 0;
+	pool = NULL;
+
+	Resize(width, height);
+	structure.Parse(BoxStructure::PYRAMID);
+	BuildBoxes();
+}
+
+
+/**
+\brief		Destructor for a World. Currently does nothing.
+*/
+World::~World(void)
+{
+}
+
+
+/**
+\brief		Advances the game objects by one fixed timestep.
+\details	Updates the position of the reptile and the awake boxes. Updates the scoreboard so
+			that the round score can be decremented. Checks the reptile for collisions
+			against the boxes touching it, and the awake boxes against the boxes touching them.
+			Adds 1 bonus point to the total score for each box that has been knocked down.
+*/
+void World::Step(void)
+{
+	// update the reptile position
+	if (reptile.Update(width, height) == true)
+	{
+		// if reptile update method returns true, 
+		// the next round is starting so the scoreboard and the boxes should be reset
+		scoreboard.StartNextRound();
+		ResetBoxes();
+	}
+
+	// update the swarm, whose reptiles start over on their own
+	swarm.Update(width, height);
+
+	// move the boxes if reptile is falling or grounded
+	if (reptile.GetState() != Reptile::STATE_FLYING)
+	{
+		StepBoxes();
+
+		// after a box has been knocked down, add 1 bonus point to total score each frame until the round restarts
+		scoreboard.AddPoints(knockedDownCount);
+	}
+
+	// update scoreboard
+	if (scoreboard.Update(width, height) == true)
+	{
+		// if the scoreboard update method returns true, 
+		// the round score for that round hit zero and the next round needs to start by resetting the reptile
+		reptile.Reset(width, height);
+		scoreboard.StartNextRound();
+	}
+
+	frameCount++;
+}
+
+
+/**
+\brief		Advances the game objects by the passed number of fixed timesteps.
+\details	Nothing is drawn between timesteps, so this runs as fast as the game logic allows
+			and is used to fast-forward headless games.
+\param[in]	frames The number of timesteps to run.
+*/
+void World::Run(unsigned long frames)
+{
+	for (unsigned long i = 0; i < frames; i++)
+	{
+		Step();
+	}
+}
+
+
+/**
+\brief		Takes a shot at the passed X and Y coordinates.
+\details	If the reptile is flying and the point is on a solid pixel of its frame, or inside it
+			when the frame has no hit mask, the reptile starts falling and the round ends so the 
+			round score stops decreasing. Otherwise the topmost flying reptile of the swarm under the
+			point starts falling, without scoring.
+\param[in]	x The X coordinate of the shot.
+\param[in]	y The Y coordinate of the shot.
+\return		SHOT_HIT if the reptile or a reptile of the swarm was hit, SHOT_MISS if the reptile was missed, 
+			or SHOT_NONE if the reptile was not flying.
+*/
+int World::Shoot(int x, int y)
+{
+	int result = SHOT_NONE;
+	if (reptile.GetState() == Reptile::STATE_FLYING)
+	{
+		result = SHOT_MISS;
+		// check for collision with reptile
+		if (reptile.CheckCollision(x, y, frameMasks[reptile.GetFrameToDraw()]) == true)
+		{
+			// set is hit for screen flash
+			reptile.SetIsHit(true);
+			// end the round to stop round score from decreasing
+			scoreboard.EndRound();
+			// set the new state for reptile
+			reptile.SetState(Reptile::STATE_FALLING);
+			result = SHOT_HIT;
+		}
+	}
+	// a shot that misses the reptile can still knock down a reptile of the swarm
+	if (result != SHOT_HIT && swarm.Shoot(x, y, frameMasks) >= 0)
+	{
+		result = SHOT_HIT;
+	}
+	return result;
+}
+
+
+/**
+\brief		Sets the size of the world and scales the reptile to fit it.
+\details	The boxes keep their starting positions and the ground they stand on, they are only placed 
+			when the World is constructed or a structure is loaded.
+\param[in]	worldWidth The new width of the world.
+\param[in]	worldHeight The new height of the world.
+*/
+void World::Resize(int worldWidth, int worldHeight)
+{
+	width = worldWidth;
+	height = worldHeight;
+	reptile.SetSize((int)(width / 9.6), height / 6);
+	swarm.SetSize((int)(width / 9.6), height / 6);
+	grid.SetSize(width, height);
+}
+
+
+/**
+\brief		Sets the width and height of all the boxes.
+\details	Called with the size of the box bitmap so that boxes collide where they are drawn. The 
+			structures are built again, so that the boxes still rest edge to edge.
+\param[in]	newWidth The new width of the boxes.
+\param[in]	newHeight The new height of the boxes.
+*/
+void World::SetBoxSize(int newWidth, int newHeight)
+{
+	boxWidth = newWidth;
+	boxHeight = newHeight;
+	BuildBoxes();
+}
+
+
+/**
+\brief		Replaces the boxes with the structures of the passed description.
+\details	The format of the description is explained in BoxStructure. The structures stand on the 
+			ground of the world at its current size.
+\param[in]	description The text describing the structures.
+\return		True if the structures were built, false if the description is not understood and the boxes
+			were left unchanged.
+*/
+bool World::LoadStructure(const string& description)
+{
+	if (structure.Parse(description) == false)
+	{
+		return false;
+	}
+	BuildBoxes();
+	return true;
+}
+
+
+/**
+\brief		Replaces the swarm with the passed number of reptiles spread along the top of the world.
+\param[in]	count The number of reptiles in the swarm, 0 to fly only the scored reptile.
+\param[in]	seed The seed the random numbers of the swarm's reptiles are made from.
+*/
+void World::SetSwarmSize(int count, unsigned int seed)
+{
+	swarm.Clear();
+	swarm.Spawn(count, seed, width, height);
+}
+
+
+/**
+\brief		Sets the hit mask that shots at a reptile drawn with the passed frame are tested against.
+\details	The mask is owned by the caller and must live as long as the World, or until it is replaced.
+			Shots are only tested against the bounds of the reptiles drawn with frames without a mask.
+\param[in]	frame The frame the mask was built from.
+\param[in]	mask The solid pixels of the frame, or NULL to test shots against the bounds of the reptile.
+*/
+void World::SetFrameMask(Reptile::Frame frame, const HitMask* mask)
+{
+	frameMasks[frame] = mask;
+}
+
+
+/**
+\brief		Sets the threads the islands of boxes are solved on.
+\details	The pool is owned by the caller and must live as long as the World, or until it is replaced. 
+			It is only used during Step, so a pool used for drawing can be shared as long as the frame 
+			is not drawn while the World steps. The boxes end up the same with or without a pool.
+\param[in]	threads The pool to solve the islands on, or NULL to solve them one after another.
+*/
+void World::SetThreadPool(ThreadPool* threads)
+{
+	pool = threads;
+}
+
+
+/**
+\brief		Returns a pointer to the reptile of the World.
+\return		A pointer to the reptile.
+*/
+Reptile* World::GetReptile(void)
+{
+	return &reptile;
+}
+
+
+/**
+\brief		Returns a pointer to the swarm of the World.
+\return		A pointer to the swarm.
+*/
+ReptileFlock* World::GetSwarm(void)
+{
+	return &swarm;
+}
+
+
+/**
+\brief		Returns a pointer to the box at the passed index.
+\param[in]	index The index of the box, from 0 to BoxCount() - 1.
+\return		A pointer to the box.
+*/
+Box* World::GetBox(int index)
+{
+	return &boxes[index];
+}
+
+
+/**
+\brief		Returns the number of boxes in the World.
+\return		The number of boxes.
+*/
+int World::BoxCount(void)
+{
+	return boxes.size();
+}
+
+
+/**
+\brief		Returns a pointer to the scoreboard of the World.
+\return		A pointer to the scoreboard.
+*/
+Scoreboard* World::GetScoreboard(void)
+{
+	return &scoreboard;
+}
+
+
+/**
+\brief		Returns the width of the World.
+\return		The width of the world.
+*/
+int World::GetWidth(void)
+{
+	return width;
+}
+
+
+/**
+\brief		Returns the height of the World.
+\return		The height of the world.
+*/
+int World::GetHeight(void)
+{
+	return height;
+}
+
+
+/**
+\brief		Returns the number of timesteps the World has run.
+\return		The number of timesteps run so far.
+*/
+unsigned long World::GetFrameCount(void)
+{
+	return frameCount;
+}
+
+
+/**
+\brief		Builds the boxes of the structure on the ground of the world at its current size, at rest.
+*/
+void World::BuildBoxes(void)
+{
+	groundY = (int)(height * GROUND);
+	structure.Build(width, groundY, boxWidth, boxHeight, &boxes);
+	grid.Clear();
+	ResetBoxes();
+}
+
+
+/**
+\brief		Puts every box back at its starting position and wakes it.
+\details	Every box is awake for the first timestep after a reset, so boxes described without anything
+			under them fall, and the rest fall asleep straight away.
+*/
+void World::ResetBoxes(void)
+{
+	int count = boxes.size();
+	isAwake.assign(count, 1);
+	isWoken.assign(count, 0);
+	isKnockedDown.assign(count, 0);
+	knockedDownCount = 0;
+	awakeBoxes.clear();
+	wokenBoxes.clear();
+	islandOf.assign(count, 0);
+	for (int i = 0; i < count; i++)
+	{
+		boxes[i].Reset();
+		PlaceBox(i);
+		awakeBoxes.push_back(i);
+	}
+}
+
+
+/**
+\brief		Moves the awake boxes for one timestep, waking the sleeping boxes they touch.
+\details	The reptile pushes the boxes it touches. When the World has a ThreadPool and enough boxes are 
+			awake, the awake boxes are split into islands that cannot touch each other during the 
+			timestep, and the islands are solved in parallel, otherwise they are solved as a single island.
+			Each island is solved in three passes, and the boxes that moved are placed in the grid between
+			them, so every pass finds the boxes where the one before left them. Sleeping boxes are never 
+			updated or checked against each other, so a structure at rest costs nothing until something 
+			touches it. The islands are merged back in order, so every run of the same game ends the same
+			whatever the number of threads.
+*/
+void World::StepBoxes(void)
+{
+	// the reptile pushes the boxes it lands on or runs into
+	bool collision = false;
+	grid.Query(reptile.GetXPos(), reptile.GetYPos(), reptile.GetWidth(), reptile.GetHeight(), &nearby);
+	for (unsigned int i = 0; i < nearby.size(); i++)
+	{
+		if (boxes[nearby[i]].CheckCollision(width, height, &reptile) == true)
+		{
+			collision = true;
+			Wake(nearby[i], &wokenBoxes);
+		}
+	}
+	// if no boxes are colliding with reptile, set reptile vertical velocity
+	if (collision == false)
+	{
+		reptile.SetYVel(5);
+	}
+	AddWokenBoxes();
+	if (awakeBoxes.empty() == true)
+	{
+		return;
+	}
+
+	// splitting the boxes only pays off when there are threads to solve the islands on
+	if (pool != NULL && (int)awakeBoxes.size() >= ISLAND_BOXES)
+	{
+		BuildIslands();
+	}
+	else
+	{
+		islandCount = 1;
+		if (islands.empty() == true)
+		{
+			islands.resize(1);
+		}
+		islands[0].solved = awakeBoxes;
+	}
+	for (int i = 0; i < islandCount; i++)
+	{
+		islands[i].awake.clear();
+		islands[i].woken.clear();
+		islands[i].landedRise = 0;
+		islands[i].landedDrop = 0;
+		islands[i].knockedDownCount = 0;
+	}
+#ifndef NDEBUG
+	if (reachedBy.size() != boxes.size())
+	{
+		std::vector<std::atomic<int> >(boxes.size()).swap(reachedBy);
+	}
+	for (unsigned int i = 0; i < reachedBy.size(); i++)
+	{
+		reachedBy[i].store(-1);
+	}
+#endif
+
+	RunIslands(&World::MoveIsland);
+	PlaceIslands();
+	RunIslands(&World::SettleIsland);
+	PlaceIslands();
+	RunIslands(&World::SleepIsland);
+
+	// merge the islands in order
+	awakeBoxes.clear();
+	for (int i = 0; i < islandCount; i++)
+	{
+		Island* island = &islands[i];
+		awakeBoxes.insert(awakeBoxes.end(), island->awake.begin(), island->awake.end());
+		wokenBoxes.insert(wokenBoxes.end(), island->woken.begin(), island->woken.end());
+		knockedDownCount += island->knockedDownCount;
+	}
+	std::sort(awakeBoxes.begin(), awakeBoxes.end());
+	AddWokenBoxes();
+}
+
+
+/**
+\brief		Splits the awake boxes into islands of the boxes that might touch during this timestep.
+\details	Boxes only move across by their speed, which is at most the speed of the fastest awake box
+			even after it has been passed from box to box, and landing and falling only move them up and 
+			down. The awake boxes are sorted by their left edge and split into runs wherever the gap 
+			between them is too wide for two boxes moving towards each other to meet, or for a sleeping
+			box to touch boxes on both sides, so each run is an island. The islands are in order from 
+			left to right and each keeps its boxes in index order, so they do not depend on the order
+			the boxes were woken in.
+*/
+void World::BuildIslands(void)
+{
+	int speed = 0;
+	spans.clear();
+	for (unsigned int i = 0; i < awakeBoxes.size(); i++)
+	{
+		int index = awakeBoxes[i];
+		int boxSpeed = (int)fabs(boxes[index].GetXVel()) + 1;
+		speed = boxSpeed > speed ? boxSpeed : speed;
+		int x;
+		int y;
+		int sweptWidth;
+		int sweptHeight;
+		GetSweptBounds(index, &x, &y, &sweptWidth, &sweptHeight);
+		spans.push_back(std::make_pair(x, index));
+	}
+	std::sort(spans.begin(), spans.end());
+
+	// start a new island wherever the next box is out of reach of the boxes to its left
+	islandCount = 0;
+	int islandRight = 0;
+	for (unsigned int i = 0; i < spans.size(); i++)
+	{
+		int index = spans[i].second;
+		int x;
+		int y;
+		int sweptWidth;
+		int sweptHeight;
+		GetSweptBounds(index, &x, &y, &sweptWidth, &sweptHeight);
+		if (islandCount == 0 || x - islandRight > 2 * speed + boxWidth)
+		{
+			islandCount++;
+			if ((int)islands.size() < islandCount)
+			{
+				islands.resize(islandCount);
+			}
+			islands[islandCount - 1].solved.clear();
+			islandRight = x + sweptWidth;
+		}
+		islandRight = x + sweptWidth > islandRight ? x + sweptWidth : islandRight;
+		islandOf[index] = islandCount - 1;
+	}
+	for (unsigned int i = 0; i < awakeBoxes.size(); i++)
+	{
+		islands[islandOf[awakeBoxes[i]]].solved.push_back(awakeBoxes[i]);
+	}
+}
+
+
+/**
+\brief		Runs one pass of the solver over every island, in parallel when the World has a ThreadPool.
+\param[in]	pass The pass, called with the index of each island.
+*/
+void World::RunIslands(void (World::*pass)(int))
+{
+	if (pool != NULL && islandCount > 1)
+	{
+		pool->ParallelFor(islandCount, std::bind(pass, this, std::placeholders::_1));
+	}
+	else
+	{
+		for (int i = 0; i < islandCount; i++)
+		{
+			(this->*pass)(i);
+		}
+	}
+}
+
+
+/**
+\brief		Places every box solved this timestep in the grid where the last pass left it.
+*/
+void World::PlaceIslands(void)
+{
+	for (int i = 0; i < islandCount; i++)
+	{
+		for (unsigned int j = 0; j < islands[i].solved.size(); j++)
+		{
+			PlaceBox(islands[i].solved[j]);
+		}
+	}
+}
+
+
+/**
+\brief		Passes the velocity of the moving boxes of an island to the resting boxes they run into, then moves them.
+\details	The boxes are checked in increasing index order against the grid as it was at the start of the
+			timestep. Only the boxes of the island are changed, so islands can be moved at the same time.
+\param[in]	index The index of the island.
+*/
+void World::MoveIsland(int index)
+{
+	Island* island = &islands[index];
+
+	// check each awake box against the boxes beside it, each pair of awake boxes only once
+	for (unsigned int i = 0; i < island->solved.size(); i++)
+	{
+		int solved = island->solved[i];
+		Box* box = &boxes[solved];
+		assert(Reach(solved, index) == true);
+		grid.Query(box->GetXPos(), box->GetYPos(), box->GetWidth(), box->GetHeight(), &island->nearby);
+		for (unsigned int j = 0; j < island->nearby.size(); j++)
+		{
+			int other = island->nearby[j];
+			Box* otherBox = &boxes[other];
+			if (other == solved || (isAwake[other] != 0 && other < solved))
+			{
+				continue;
+			}
+			assert(Reach(other, index) == true);
+			// boxes beside each other overlap vertically, while stacked boxes only touch
+			if (box->GetYPos() < otherBox->GetYPos() + otherBox->GetHeight() &&
+				otherBox->GetYPos() < box->GetYPos() + box->GetHeight() &&
+				box->CheckCollision(width, height, otherBox, true) == true)
+			{
+				Wake(other, &island->woken);
+			}
+		}
+	}
+
+	// update position of each awake box
+	for (unsigned int i = 0; i < island->solved.size(); i++)
+	{
+		boxes[island->solved[i]].Update(width, height);
+	}
+}
+
+
+/**
+\brief		Lands the awake boxes of an island on the ground or on the boxes under them, or drops them.
+\param[in]	index The index of the island.
+*/
+void World::SettleIsland(int index)
+{
+	Island* island = &islands[index];
+	for (unsigned int i = 0; i < island->solved.size(); i++)
+	{
+		SettleBox(island->solved[i], island);
+	}
+}
+
+
+/**
+\brief		Wakes the boxes touching the boxes of an island that moved, and puts its boxes at rest to sleep.
+\param[in]	index The index of the island.
+*/
+void World::SleepIsland(int index)
+{
+	Island* island = &islands[index];
+	for (unsigned int i = 0; i < island->solved.size(); i++)
+	{
+		int solved = island->solved[i];
+		Box* box = &boxes[solved];
+		if (box->GetXPos() != box->GetXPrevPos() || box->GetYPos() != box->GetYPrevPos())
+		{
+			QueryBox(solved, &island->nearby);
+			for (unsigned int j = 0; j < island->nearby.size(); j++)
+			{
+				assert(Reach(island->nearby[j], index) == true);
+				Wake(island->nearby[j], &island->woken);
+			}
+			island->awake.push_back(solved);
+		}
+		else if (box->GetYVel() == 0 && (int)box->GetXVel() == 0)
+		{
+			// friction never stops a box exactly, so the velocity too small to move it is dropped
+			box->SetXVel(0);
+			isAwake[solved] = 0;
+		}
+		else
+		{
+			island->awake.push_back(solved);
+		}
+	}
+}
+
+
+/**
+\brief		Lands a box on the ground or on the highest box under it, or drops it if nothing is under it.
+\details	A box is under another if they overlap across and its top is no higher than the other box
+			can have fallen into it in one timestep. A box landing is moved back up to rest on top, and
+			a box dropped for the first time since the last reset is counted as knocked down.
+\param[in]	index The index of the box.
+\param[in,out]	island The island of the box, which keeps how far the boxes have landed and counts the boxes knocked down.
+*/
+void World::SettleBox(int index, Island* island)
+{
+	Box* box = &boxes[index];
+	int rest = groundY - box->GetHeight();
+	bool isSupported = (box->GetYPos() >= rest);
+
+	// the boxes landed earlier in this pass have only moved up or down since they were placed in the grid,
+	// so they are looked for that much farther away and then checked against where they are now
+	int top = box->GetYPos();
+	int bottom = box->GetYPos() + box->GetHeight();
+	grid.Query(box->GetXPos(), top - island->landedDrop, box->GetWidth(), bottom - top + island->landedDrop + island->landedRise, &island->touching);
+	if (island->landedDrop > 0 || island->landedRise > 0)
+	{
+		unsigned int touchingCount = 0;
+		for (unsigned int i = 0; i < island->touching.size(); i++)
+		{
+			Box* other = &boxes[island->touching[i]];
+			int otherTop = other->GetYPos() < other->GetYPrevPos() ? other->GetYPos() : other->GetYPrevPos();
+			int otherBottom = (other->GetYPos() > other->GetYPrevPos() ? other->GetYPos() : other->GetYPrevPos()) + other->GetHeight();
+			if (otherTop <= bottom && top <= otherBottom)
+			{
+				island->touching[touchingCount++] = island->touching[i];
+			}
+		}
+		island->touching.resize(touchingCount);
+	}
+
+	for (unsigned int i = 0; i < island->touching.size(); i++)
+	{
+		Box* other = &boxes[island->touching[i]];
+		if (island->touching[i] != index &&
+			other->GetXPos() < box->GetXPos() + box->GetWidth() && box->GetXPos() < other->GetXPos() + other->GetWidth() &&
+			other->GetYPos() >= box->GetYPos() + box->GetHeight() - FALL_SPEED)
+		{
+			isSupported = true;
+			rest = other->GetYPos() - box->GetHeight() < rest ? other->GetYPos() - box->GetHeight() : rest;
+		}
+	}
+
+	if (isSupported == true)
+	{
+		if (box->GetYPos() != rest)
+		{
+			if (rest < box->GetYPos())
+			{
+				island->landedRise = box->GetYPos() - rest > island->landedRise ? box->GetYPos() - rest : island->landedRise;
+			}
+			else
+			{
+				island->landedDrop = rest - box->GetYPos() > island->landedDrop ? rest - box->GetYPos() : island->landedDrop;
+			}
+			box->MoveTo(box->GetXPos(), rest);
+		}
+		box->SetYVel(0);
+	}
+	else
+	{
+		box->SetYVel(FALL_SPEED);
+		if (isKnockedDown[index] == 0)
+		{
+			isKnockedDown[index] = 1;
+			island->knockedDownCount++;
+		}
+	}
+}
+
+
+/**
+\brief		Wakes a sleeping box, which is updated from the next timestep on.
+\param[in]	index The index of the box.
+\param[out]	woken The boxes woken so far, which the box is added to if it was asleep.
+*/
+void World::Wake(int index, std::vector<int>* woken)
+{
+	if (isAwake[index] == 0 && isWoken[index] == 0)
+	{
+		isWoken[index] = 1;
+		woken->push_back(index);
+	}
+}
+
+
+/**
+\brief		Adds the boxes woken since the last call to the awake boxes, keeping them in index order.
+*/
+void World::AddWokenBoxes(void)
+{
+	if (wokenBoxes.empty() == true)
+	{
+		return;
+	}
+	for (unsigned int i = 0; i < wokenBoxes.size(); i++)
+	{
+		isAwake[wokenBoxes[i]] = 1;
+		isWoken[wokenBoxes[i]] = 0;
+		awakeBoxes.push_back(wokenBoxes[i]);
+	}
+	wokenBoxes.clear();
+	std::sort(awakeBoxes.begin(), awakeBoxes.end());
+}
+
+
+/**
+\brief		Places a box in the grid, covering both where it is and where it was before its last update.
+\details	A sideways collision moves a box back to where it was, so covering both positions finds every
+			box it can touch during the collision checks of the timestep.
+\param[in]	index The index of the box.
+*/
+void World::PlaceBox(int index)
+{
+	int x;
+	int y;
+	int sweptWidth;
+	int sweptHeight;
+	GetSweptBounds(index, &x, &y, &sweptWidth, &sweptHeight);
+	grid.Place(index, x, y, sweptWidth, sweptHeight);
+}
+
+
+/**
+\brief		Finds the other boxes touching where a box is or where it was before its last update.
+\param[in]	index The index of the box.
+\param[out]	found Replaced by the indices of the touching boxes, in increasing order.
+*/
+void World::QueryBox(int index, std::vector<int>* found)
+{
+	int x;
+	int y;
+	int sweptWidth;
+	int sweptHeight;
+	GetSweptBounds(index, &x, &y, &sweptWidth, &sweptHeight);
+	grid.Query(x, y, sweptWidth, sweptHeight, found);
+	found->erase(std::remove(found->begin(), found->end(), index), found->end());
+}
+
+
+/**
+\brief		Records that an island has reached a box, to check in debug builds that the islands stay apart.
+\details	Islands are solved at the same time, so a box pushed or woken from two of them would be changed
+			by two threads at once. BuildIslands leaves gaps between the islands that no box can cross in
+			a timestep, and this catches a change to the sizes or speeds of the boxes that breaks that.
+			It is only called from asserts, so it costs nothing in release builds.
+\param[in]	index The index of the box.
+\param[in]	island The index of the island reaching the box.
+\return		True if no other island has reached the box during this timestep.
+*/
+bool World::Reach(int index, int island)
+{
+	int reached = -1;
+	return reachedBy[index].compare_exchange_strong(reached, island) == true || reached == island;
+}
+
+
+/**
+\brief		Returns the bounding box of where a box is and where it was before its last update.
+\param[in]	index The index of the box.
+\param[out]	x The X coordinate of the bounding box.
+\param[out]	y The Y coordinate of the bounding box.
+\param[out]	sweptWidth The width of the bounding box.
+\param[out]	sweptHeight The height of the bounding box.
+*/
+void World::GetSweptBounds(int index, int* x, int* y, int* sweptWidth, int* sweptHeight)
+{
+	Box* box = &boxes[index];
+	int left = box->GetXPos() < box->GetXPrevPos() ? box->GetXPos() : box->GetXPrevPos();
+	int top = box->GetYPos() < box->GetYPrevPos() ? box->GetYPos() : box->GetYPrevPos();
+	int right = box->GetXPos() > box->GetXPrevPos() ? box->GetXPos() : box->GetXPrevPos();
+	int bottom = box->GetYPos() > box->GetYPrevPos() ? box->GetYPos() : box->GetYPrevPos();
+	*x = left;
+	*y = top;
+	*sweptWidth = right - left + box->GetWidth();
+	*sweptHeight = bottom - top + box->GetHeight();
+}
\ No newline at end of file
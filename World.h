@@ -0,0 +1,131 @@
+#include "Reptile.h"
+#include "ReptileFlock.h"
+#include "Box.h"
+#include "BoxStructure.h"
+#include "Scoreboard.h"
+#include "SpatialGrid.h"
+#include "ThreadPool.h"
+#include <string>
+#include <vector>
+#include <atomic>
+using namespace std;
+
+
+#ifndef __WORLD_H__
+#define __WORLD_H__
+
+
+/**
+\class		World
+\author		Tom Bisch
+\date		Apr 12, 2016
+\brief		Owns and steps the state of an Unhappy Flying Reptiles game without drawing anything.
+\details	A World instance contains the reptile, the boxes and the scoreboard of a single game and advances
+			them one fixed timestep at a time. It has no dependency on a window or on GDI+, so the same game
+			logic drives the window in Main.cpp and headless runs that fast-forward through many frames for
+			score validation and balancing. The window only forwards its size and the player's shots, and 
+			reads back the positions of the game objects to draw them. The boxes are built from a 
+			BoxStructure description and kept in a SpatialGrid, so each timestep only checks the objects 
+			that touch for collisions. Boxes at rest sleep until something touches them, so large
+			structures only cost anything while they are being knocked down. The awake boxes are split
+			each timestep into islands that cannot touch each other, which are solved in parallel when 
+			the World is given a ThreadPool. Each island is solved in index order and merged back in 
+			island order, so a game ends the same whatever the number of threads.
+*/
+class World
+{
+
+private:
+	// a group of boxes that cannot touch any box outside of it during a timestep
+	struct Island
+	{
+		std::vector<int> solved;		// the boxes awake at the start of the timestep, in increasing order
+		std::vector<int> awake;			// the boxes still awake at the end of the timestep
+		std::vector<int> woken;			// the boxes woken during the timestep
+		std::vector<int> nearby;		// the boxes touching the box being checked
+		std::vector<int> touching;		// the boxes touching the box being settled
+		int landedRise;					// the farthest a box has been moved up to land during the timestep
+		int landedDrop;					// the farthest a box has been moved down to land during the timestep
+		int knockedDownCount;			// the number of boxes knocked down during the timestep
+	};
+
+	Reptile reptile;					// the flying reptile
+	ReptileFlock swarm;					// the extra reptiles flown in swarm mode, which are not scored
+	std::vector<Box> boxes;				// the boxes stacked on the ground
+	BoxStructure structure;				// the description the boxes are built from
+	std::vector<unsigned char> isAwake;	// indicates if each box is in the awake boxes
+	std::vector<unsigned char> isWoken;	// indicates if each box is waiting to join the awake boxes
+	std::vector<unsigned char> isKnockedDown;	// indicates if each box has fallen since the last reset
+	std::vector<int> awakeBoxes;		// the boxes updated each timestep, in increasing order
+	std::vector<int> wokenBoxes;		// the boxes woken during this timestep
+	int knockedDownCount;				// the number of boxes that have fallen since the last reset
+	int boxWidth;						// the width of every box
+	int boxHeight;						// the height of every box
+	int groundY;						// the Y coordinate of the ground the boxes were built on
+	Scoreboard scoreboard;				// the scores of the game
+	SpatialGrid grid;					// the boxes, by index, for finding what touches what
+	std::vector<int> nearby;			// the boxes touching the reptile or a box in this timestep
+	std::vector<Island> islands;		// the islands of this timestep, kept to reuse their lists
+	int islandCount;					// the number of islands in use this timestep
+	std::vector<std::pair<int, int> > spans;	// the left edge and index of each awake box, sorted to find the islands
+	std::vector<int> islandOf;			// the island of each awake box this timestep
+	ThreadPool* pool;					// the threads the islands are solved on, or NULL to solve them in turn
+	std::vector<std::atomic<int> > reachedBy;	// the island that reached each box this timestep, only kept in debug builds
+	const HitMask* frameMasks[Reptile::FRAME_COUNT];	// the hit mask of each reptile frame, or NULL
+	int width;							// the width of the world
+	int height;							// the height of the world
+	unsigned long frameCount;			// the number of timesteps run so far
+
+	void BuildBoxes(void);
+	void ResetBoxes(void);
+	void StepBoxes(void);
+	void BuildIslands(void);
+	void RunIslands(void (World::*pass)(int));
+	void PlaceIslands(void);
+	void MoveIsland(int index);
+	void SettleIsland(int index);
+	void SleepIsland(int index);
+	void SettleBox(int index, Island* island);
+	void Wake(int index, std::vector<int>* woken);
+	void AddWokenBoxes(void);
+	void PlaceBox(int index);
+	void QueryBox(int index, std::vector<int>* found);
+	bool Reach(int index, int island);
+	void GetSweptBounds(int index, int* x, int* y, int* sweptWidth, int* sweptHeight);
+
+public:
+	static const int TIMESTEP;			// the duration of one timestep in milliseconds
+	static const int BOX_SIZE;			// the default width and height of a box
+	static const int FALL_SPEED;		// the number of pixels a box falls each timestep
+	static const int ISLAND_BOXES;		// the fewest awake boxes split into islands to be solved in parallel
+	static const double GROUND;			// the height of the ground the boxes stand on, as a fraction of the world's height
+	static const int SHOT_NONE;			// a shot was taken while the reptile was not flying
+	static const int SHOT_MISS;			// a shot missed the flying reptile
+	static const int SHOT_HIT;			// a shot hit the flying reptile
+
+	World(int worldWidth, int worldHeight, unsigned int seed = 1);
+	~World(void);
+
+	void Step(void);
+	void Run(unsigned long frames);
+	int Shoot(int x, int y);
+	void Resize(int worldWidth, int worldHeight);
+	void SetBoxSize(int newWidth, int newHeight);
+	bool LoadStructure(const string& description);
+	void SetSwarmSize(int count, unsigned int seed = 1);
+	void SetFrameMask(Reptile::Frame frame, const HitMask* mask);
+	void SetThreadPool(ThreadPool* threads);
+
+	Reptile* GetReptile(void);
+	ReptileFlock* GetSwarm(void);
+	Box* GetBox(int index);
+	int BoxCount(void);
+	Scoreboard* GetScoreboard(void);
+	int GetWidth(void);
+	int GetHeight(void);
+	unsigned long GetFrameCount(void);
+
+};
+
+
+#endif
\ No newline at end of file